@@ -0,0 +1,46 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+#version 450
+
+// Full-screen triangle, generated from gl_VertexID.
+// No vertex buffers need to be bound.
+
+out mediump vec2 warpNdc;
+out gl_PerVertex { vec4 gl_Position; };
+
+void main( void )
+{
+	vec2 ndc = vec2((gl_VertexID == 1) ? 3.0 : -1.0,
+					(gl_VertexID == 2) ? 3.0 : -1.0);
+	gl_Position = vec4(ndc, 0.5, 1.0);
+	warpNdc = ndc;
+}
@@ -0,0 +1,52 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+#version 450
+
+layout(binding = 1) uniform highp sampler2D Texture;
+
+#include "openwarp_pose.glsl"
+
+in mediump vec2 warpNdc;
+out mediump vec4 outColor;
+
+void main()
+{
+	vec3 renderNdc = u_homography * vec3(warpNdc, 1.0);
+
+	// Directions behind the rendered camera have nothing to sample;
+	// push them off the edge of the eye buffer, like the mesh warp does.
+	if(renderNdc.z <= 0.0) {
+		renderNdc = vec3(sign(warpNdc) * 2.0, 1.0);
+	}
+
+	outColor = texture(Texture, (renderNdc.xy / renderNdc.z + 1.0) * 0.5);
+}
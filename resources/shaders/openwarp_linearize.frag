@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+#version 450
+
+// Converts the non-linear eye buffer depth to linear view-space depth
+// (distance along the view axis), once per rendered frame, so the warps
+// don't have to re-derive it on every fetch.
+
+layout(binding = 2) uniform highp sampler2D _Depth;
+
+// Clip planes of the rendered frame's projection.
+uniform highp float u_near;
+uniform highp float u_far;
+
+layout(location = 0) out highp float outDepth;
+
+void main()
+{
+	float z = texelFetch(_Depth, ivec2(gl_FragCoord.xy), 0).x * 2.0 - 1.0;
+	outDepth = 2.0 * u_near * u_far / (u_far + u_near - z * (u_far - u_near));
+}
@@ -33,7 +33,8 @@ SOFTWARE.
 
 uniform highp mat4x4 u_renderInverseP;
 uniform highp mat4x4 u_renderInverseV;
-uniform highp mat4x4 u_warpVP;
+
+#include "openwarp_pose.glsl"
 
 uniform mediump float bleedRadius;
 uniform mediump float edgeTolerance;
@@ -42,33 +43,47 @@ layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec2 in_uv;
 
 layout(binding = 1) uniform highp sampler2D Texture;
-layout(binding = 2) uniform highp sampler2D _Depth;
+
+// Linear view-space depth of the rendered frame.
+layout(binding = 4) uniform highp sampler2D _LinearDepth;
+
+// Clip planes of the rendered frame's projection.
+uniform highp float u_near;
+uniform highp float u_far;
+
 out mediump vec4 worldspace;
 out mediump vec2 warpUv;
 out gl_PerVertex { vec4 gl_Position; };
 
+// NDC depth of a point at the given linear view-space depth.
+float NdcDepth(float linearDepth)
+{
+	return (u_far + u_near - 2.0 * u_near * u_far / linearDepth) / (u_far - u_near);
+}
 
 void main( void )
 {
-	float z = textureLod(_Depth, in_uv, 0.0).x * 2.0 - 1.0;
+	float z = NdcDepth(textureLod(_LinearDepth, in_uv, 0.0).x);
 
 	float outlier = min(              											
 					  min(														
-							textureLod(_Depth, in_uv - vec2(bleedRadius,0), 0).x, 
-							textureLod(_Depth, in_uv + vec2(bleedRadius,0), 0).x  
+							textureLod(_LinearDepth, in_uv - vec2(bleedRadius,0), 0).x, 
+							textureLod(_LinearDepth, in_uv + vec2(bleedRadius,0), 0).x  
 					  ),														
 					  min(
-							textureLod(_Depth, in_uv - vec2(0,bleedRadius), 0).x, 
-							textureLod(_Depth, in_uv + vec2(0,bleedRadius), 0).x  
+							textureLod(_LinearDepth, in_uv - vec2(0,bleedRadius), 0).x, 
+							textureLod(_LinearDepth, in_uv + vec2(0,bleedRadius), 0).x  
 					  )
 					);
 
-	float diags = min(textureLod(_Depth, in_uv + sqrt(2) * vec2(bleedRadius,bleedRadius), 0).x,
-				textureLod(_Depth, in_uv - sqrt(2) * vec2(bleedRadius,bleedRadius), 0).x);
+	float diags = min(textureLod(_LinearDepth, in_uv + sqrt(2) * vec2(bleedRadius,bleedRadius), 0).x,
+				textureLod(_LinearDepth, in_uv - sqrt(2) * vec2(bleedRadius,bleedRadius), 0).x);
 
 	outlier = min(diags, outlier);
 
-	outlier = outlier * 2.0 - 1.0;
+	// Linear and NDC depth sort the same way, so the closest
+	// neighbour can be picked before converting.
+	outlier = NdcDepth(outlier);
 	if(z - outlier > edgeTolerance){
 		z = outlier;
 	}
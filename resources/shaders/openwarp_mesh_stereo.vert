@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+#version 450
+
+// Stereo variant of openwarp_mesh.vert: warps both eyes of a stereo eye
+// buffer in a single submission. How each vertex finds its eye depends
+// on what the driver supports, selected with a #define at link time:
+//   OPENWARP_MULTIVIEW  GL_OVR_multiview2; one draw broadcast to both views.
+//   OPENWARP_LAYERED    One instanced draw, an instance per eye, each
+//                       routed to its layer with gl_Layer.
+//   (neither)           One draw per eye, picked by u_eye.
+#if defined(OPENWARP_MULTIVIEW)
+#extension GL_OVR_multiview2 : require
+layout(num_views = 2) in;
+#define EYE int(gl_ViewID_OVR)
+#elif defined(OPENWARP_LAYERED)
+#extension GL_ARB_shader_viewport_layer_array : require
+#define EYE gl_InstanceID
+#else
+uniform int u_eye;
+#define EYE u_eye
+#endif
+
+// Per eye inverse projection and camera matrix of the rendered frame.
+uniform highp mat4x4 u_renderInverseP[2];
+uniform highp mat4x4 u_renderInverseV[2];
+
+#include "openwarp_pose.glsl"
+
+uniform mediump float bleedRadius;
+uniform mediump float edgeTolerance;
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec2 in_uv;
+
+// Depth buffers of both eyes, as rendered (window-space depth).
+layout(binding = 2) uniform highp sampler2DArray _StereoDepth;
+
+out mediump vec4 worldspace;
+out mediump vec2 warpUv;
+flat out int eye;
+
+float NdcDepth(vec2 uv)
+{
+	return textureLod(_StereoDepth, vec3(uv, EYE), 0.0).x * 2.0 - 1.0;
+}
+
+void main( void )
+{
+	float z = NdcDepth(in_uv);
+
+	// Same edge bleed as the mono mesh warp: pull vertices on a depth
+	// edge forward onto the closest neighbour.
+	vec2 axis = vec2(bleedRadius, 0);
+	vec2 diagonal = sqrt(2) * vec2(bleedRadius, bleedRadius);
+	float outlier = min(min(NdcDepth(in_uv - axis), NdcDepth(in_uv + axis)),
+						min(NdcDepth(in_uv - axis.yx), NdcDepth(in_uv + axis.yx)));
+	outlier = min(outlier, min(NdcDepth(in_uv + diagonal), NdcDepth(in_uv - diagonal)));
+	if(z - outlier > edgeTolerance){
+		z = outlier;
+	}
+	z = min(0.99, z);
+
+	vec4 clipSpacePosition = vec4(in_uv * 2.0 - 1.0, z, 1.0);
+	vec4 frag_viewspace = u_renderInverseP[EYE] * clipSpacePosition;
+	vec4 frag_worldspace = u_renderInverseV[EYE] * frag_viewspace;
+	vec4 result = u_eyeWarpVP[EYE] * frag_worldspace;
+
+	result /= abs(result.w);
+	gl_Position = result;
+#if defined(OPENWARP_LAYERED)
+	gl_Layer = EYE;
+#endif
+	worldspace = frag_worldspace;
+	warpUv = in_uv;
+	eye = EYE;
+}
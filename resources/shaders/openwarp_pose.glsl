@@ -0,0 +1,52 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+// Fresh pose the warp reprojects to. Not a complete shader;
+// pulled in with #include after the #version line.
+//
+// Late-latched: the application may rewrite this block after the
+// warp has been issued, right up until it is flushed to the GPU.
+layout(std140, binding = 0) uniform WarpPose {
+    // VP matrix of the fresh pose, and its inverse.
+    highp mat4x4 u_warpVP;
+    highp mat4x4 u_warpInverseVP;
+
+    // World-space position of the fresh pose.
+    highp vec3 u_warpPos;
+
+    // Maps homogeneous NDC of the fresh pose to homogeneous NDC of the
+    // rendered pose, for the homography (rotation-only / planar) warps.
+    highp mat3x3 u_homography;
+
+    // VP matrices of each eye at the fresh pose, left eye first,
+    // for the stereo warp.
+    highp mat4x4 u_eyeWarpVP[2];
+};
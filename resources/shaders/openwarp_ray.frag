@@ -31,86 +31,29 @@ SOFTWARE.
 
 #version 450 
 
-layout(binding = 1) uniform highp sampler2D Texture;
-layout(binding = 2) uniform highp sampler2D _Depth;
-
-uniform lowp float u_debugOpacity;
-
-uniform highp mat4x4 u_warpInverseVP;
-uniform highp mat4x4 u_renderPV;
-
-uniform mediump vec3 u_warpPos;
-
-uniform mediump float u_power;
-uniform mediump float u_stepSize;
-uniform mediump float u_depthOffset;
-uniform lowp float u_occlusionThreshold;
-uniform lowp float u_occlusionOffset;
-
 in mediump vec4 worldspace;
 in mediump vec2 warpUv;
 out mediump vec4 outColor;
 
+#include "openwarp_ray_common.glsl"
 
-vec3 ndcFromWorld(vec4 worldCoords, mat4x4 PV){
-    vec4 clipSpacePosition = PV * worldCoords;
-    clipSpacePosition /= clipSpacePosition.w;
-    return clipSpacePosition.xyz;
-}
+// Per-pixel world-space hits of the previous warp, for temporal reuse.
+layout(rgba32f, binding = 1) uniform image2D u_history;
 
-float LinearEyeDepth(float nonlinearDepth, float zNear, float zFar){
-    return 2.0 * zNear * zFar / (zFar + zNear - nonlinearDepth * (zFar - zNear));
+float sampleDepth(vec2 uv)
+{
+    return texture(_LinearDepth, uv).r;
 }
 
 void main()
 {
-    float counter = 0.01;
-    int iter = 0;
-
-    vec4 V_worldspace = u_warpInverseVP * vec4(warpUv * 2.0 - 1.0, 1.0, 1);
-    vec4 marchingPoint_worldspace = vec4(u_warpPos,1) + V_worldspace;
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 history = u_useHistory ? imageLoad(u_history, pixel) : vec4(0.0);
 
-    vec3 ndc;
-    vec3 ndc2;
-    float calcDepth;
-    float calcDepth2;
-    float lastDepth;
-    float lastStep;
+    vec4 hit, hitPoint;
+    outColor = marchRay(warpUv, history, hit, hitPoint);
 
-    float marchDepth, marchDepth2;
-
-    float accum = 0;
-    float delta;
-    float delta2;
-
-
-    vec4 color = texture(Texture,warpUv);
-    vec3 og_ndc = ndcFromWorld(marchingPoint_worldspace, u_renderPV);
-
-    // Adjust iterations here, to taste.
-    for(; iter < 32; iter++){
-        
-        // We calculate the point in the old pose's NDC space.
-        ndc = ndcFromWorld(marchingPoint_worldspace, u_renderPV);
-
-        calcDepth = LinearEyeDepth(texture(_Depth,(ndc.xy + 1.) * 0.5).r, 0.1, 100);
-        marchDepth = LinearEyeDepth((ndc.z + 1.0) * 0.5, 0.1, 100);
-
-        delta = calcDepth - marchDepth;
-            
-        lastStep = clamp(delta * u_depthOffset, -u_stepSize, u_stepSize);
-        //lastStep = u_stepSize;
-        marchingPoint_worldspace += V_worldspace * lastStep;
-        lastDepth = calcDepth;
-        float factor = clamp(1-pow(abs(delta), u_power),0,1);
-        accum += factor;
-        color = mix(color,texture(Texture,(ndc.xy + 1)*0.5),factor);
+    if(u_useHistory) {
+        imageStore(u_history, pixel, hitPoint);
     }
-
-    // Occlusion hole-filling.
-    float occlusionFactor = step(u_occlusionThreshold, abs(delta));
-    marchingPoint_worldspace -= V_worldspace * occlusionFactor * u_occlusionOffset;
-    ndc = ndcFromWorld(marchingPoint_worldspace, u_renderPV);
-    color = mix(color,texture(Texture,(ndc.xy + 1)*0.5),occlusionFactor);
-    outColor = color;
 }
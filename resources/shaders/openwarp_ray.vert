@@ -33,7 +33,6 @@ SOFTWARE.
 
 uniform highp mat4x4 u_renderInverseP;
 uniform highp mat4x4 u_renderInverseV;
-uniform highp mat4x4 u_warpVP;
 
 uniform mediump float bleedRadius;
 uniform mediump float edgeTolerance;
@@ -0,0 +1,405 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+// Shared by the fragment (openwarp_ray.frag) and compute
+// (openwarp_ray.comp) raymarch paths. Not a complete shader;
+// pulled in with #include after the #version line.
+
+layout(binding = 1) uniform highp sampler2D Texture;
+// Linear view-space depth of the rendered frame.
+layout(binding = 4) uniform highp sampler2D _LinearDepth;
+
+// Hierarchical min/max depth pyramid of _LinearDepth (R = min, G = max).
+layout(binding = 3) uniform highp sampler2D _HiZ;
+
+// Near clip plane of the rendered frame's projection.
+uniform highp float u_near;
+
+uniform lowp float u_debugOpacity;
+
+#include "openwarp_pose.glsl"
+
+uniform highp mat4x4 u_renderPV;
+
+uniform mediump float u_power;
+uniform mediump float u_stepSize;
+uniform mediump float u_depthOffset;
+uniform lowp float u_occlusionThreshold;
+uniform lowp float u_occlusionOffset;
+
+// Hierarchical tracing. When enabled, the ray skips empty space using
+// the depth pyramid, and only a few of the regular iterations are
+// needed to refine the hit.
+uniform bool u_useHiZ;
+uniform int u_hizMaxLevel;
+uniform int u_hizRefineIterations;
+
+const int HIZ_MAX_ITERATIONS = 48;
+
+// Upper bound on regular march iterations.
+uniform int u_maxIterations;
+
+// Stop marching once |delta| (linear depth error) drops below this.
+// Zero disables early termination.
+uniform mediump float u_convergenceThreshold;
+
+// Only fetch and blend color at the final hit, rather than every iteration.
+uniform bool u_deferredColor;
+
+// Output a heatmap of the per-pixel iteration count instead of color.
+uniform bool u_debugIterations;
+
+// Temporal reuse. The previous warp's hit at this pixel, projected onto
+// the fresh ray, is refined with a few iterations; the ray is only
+// marched in full if that doesn't land within u_historyTolerance.
+uniform bool u_useHistory;
+uniform int u_historyIterations;
+uniform mediump float u_historyTolerance;
+
+// Adaptive iteration budget. The furthest a point can shift between
+// the two poses is u_parallaxScale * (1 / nearest - 1 / farthest depth),
+// in output pixels; the ray gets u_iterationsPerPixel iterations per
+// pixel of that, on top of u_minIterations, up to u_maxIterations.
+uniform bool u_adaptiveIterations;
+uniform highp float u_parallaxScale;
+uniform mediump float u_iterationsPerPixel;
+uniform int u_minIterations;
+
+// Depth range (min, max) the adaptive budget is computed over. Left at
+// zero, the whole frame's range is used; the compute path may narrow
+// it to what a tile's rays can see.
+vec2 marchDepthRange = vec2(0.0);
+
+// Linear depth of the rendered frame at the given eye buffer UV.
+// Defined by the including shader, so each path can fetch it its own way.
+float sampleDepth(vec2 uv);
+
+vec3 ndcFromWorld(vec4 worldCoords, mat4x4 PV){
+    vec4 clipSpacePosition = PV * worldCoords;
+    clipSpacePosition /= clipSpacePosition.w;
+    return clipSpacePosition.xyz;
+}
+
+// Trace the ray O + s * D through the depth pyramid, from sStart to sEnd.
+// Returns the s at which the ray first reaches the depth buffer,
+// or -1 if it leaves the eye buffer (or runs out of iterations) first.
+float traceHiZ(vec3 O, vec3 D, float sStart, float sEnd, out int steps)
+{
+    // Clip coordinates are linear in s; NDC are not.
+    vec4 c0 = u_renderPV * vec4(O, 1.0);
+    vec4 cd = u_renderPV * vec4(D, 0.0);
+
+    float s = sStart;
+    int level = 0;
+
+    for(steps = 0; steps < HIZ_MAX_ITERATIONS; steps++) {
+        if(level < 0) {
+            return s;
+        }
+        if(s >= sEnd) {
+            break;
+        }
+
+        vec4 c = c0 + cd * s;
+        vec3 ndc = c.xyz / c.w;
+        if(c.w <= 0.0 || any(greaterThan(abs(ndc.xy), vec2(1.0)))) {
+            break;
+        }
+
+        vec2 cellCount = vec2(textureSize(_HiZ, level));
+        vec2 cell = min(floor((ndc.xy * 0.5 + 0.5) * cellCount), cellCount - 1.0);
+        vec2 minMax = texelFetch(_HiZ, ivec2(cell), level).rg;
+        // Clip-space w is the linear view depth.
+        float rayZ = c.w;
+
+        if(rayZ >= minMax.x) {
+            // The ray may already be behind something in this cell; look closer.
+            level--;
+            continue;
+        }
+
+        // Where the ray leaves this cell, in the direction it moves across the screen.
+        // Solving ndc.x(s) = (c0.x + s * cd.x) / (c0.w + s * cd.w) = boundary.x, and likewise for y.
+        vec2 direction = cd.xy * c.w - c.xy * cd.w;
+        vec2 boundary = mix(cell, cell + 1.0, step(0.0, direction)) / cellCount * 2.0 - 1.0;
+        vec2 sBoundary = (boundary * c0.w - c0.xy) / (cd.xy - boundary * cd.w);
+        sBoundary = mix(sBoundary, vec2(sEnd), lessThan(abs(direction), vec2(1e-9)));
+        float sExit = min(sBoundary.x, sBoundary.y);
+
+        // Where the ray reaches the closest depth in this cell.
+        float sPlane = (minMax.x - c0.w) / cd.w;
+
+        if(sPlane > s && sPlane < sExit) {
+            // It might hit something before leaving the cell.
+            s = sPlane;
+            level--;
+        } else {
+            // The whole cell is empty along the ray; skip it, and take
+            // bigger strides from here on.
+            s = max(sExit, s) + 1e-4 * max(s, 1.0);
+            level = min(level + 1, u_hizMaxLevel);
+        }
+    }
+
+    return -1.0;
+}
+
+// Bounds of where the fresh rays through the output UV rectangle
+// [uvMin, uvMax] can land in the eye buffer, in the rendered frame's
+// NDC (xy = min, zw = max), given that nothing is closer than minDepth.
+// Each ray runs from minDepth out to the far plane; the pose delta
+// sets how far apart those two ends project.
+vec4 rayFootprint(vec2 uvMin, vec2 uvMax, float minDepth)
+{
+    vec4 eye = u_renderPV * vec4(u_warpPos, 1.0);
+
+    vec2 lo = vec2(1.0);
+    vec2 hi = vec2(-1.0);
+    for(int corner = 0; corner < 4; corner++) {
+        vec2 uv = mix(uvMin, uvMax, vec2(corner & 1, corner >> 1));
+        vec4 farPoint = u_warpInverseVP * vec4(uv * 2.0 - 1.0, 1.0, 1.0);
+        vec4 far = u_renderPV * vec4(farPoint.xyz / farPoint.w, 1.0);
+
+        vec2 farNdc = far.xy / far.w;
+        lo = min(lo, farNdc);
+        hi = max(hi, farNdc);
+
+        // Clip coordinates are linear along the ray.
+        float t = (minDepth - eye.w) / (far.w - eye.w);
+        if(t > 0.0 && t < 1.0) {
+            vec4 near = mix(eye, far, t);
+            lo = min(lo, near.xy / near.w);
+            hi = max(hi, near.xy / near.w);
+        }
+    }
+
+    return vec4(lo, hi);
+}
+
+// Min/max depth over the given NDC rectangle of the eye buffer, from the
+// pyramid level at which it covers at most 2x2 texels.
+vec2 footprintDepthRange(vec4 footprint)
+{
+    vec2 depthSize = vec2(textureSize(_HiZ, 0));
+    vec2 lo = clamp(footprint.xy * 0.5 + 0.5, 0.0, 1.0) * depthSize;
+    vec2 hi = clamp(footprint.zw * 0.5 + 0.5, 0.0, 1.0) * depthSize;
+
+    float extent = max(max(hi.x - lo.x, hi.y - lo.y), 1.0);
+    int level = clamp(int(ceil(log2(extent))), 0, u_hizMaxLevel);
+
+    ivec2 levelSize = textureSize(_HiZ, level);
+    ivec2 cellLo = clamp(ivec2(lo) >> level, ivec2(0), levelSize - 1);
+    ivec2 cellHi = clamp(ivec2(hi) >> level, ivec2(0), levelSize - 1);
+
+    vec2 range = vec2(1.0e30, 0.0);
+    for(int y = cellLo.y; y <= min(cellHi.y, cellLo.y + 1); y++) {
+        for(int x = cellLo.x; x <= min(cellHi.x, cellLo.x + 1); x++) {
+            vec2 minMax = texelFetch(_HiZ, ivec2(x, y), level).rg;
+            range = vec2(min(range.x, minMax.x), max(range.y, minMax.y));
+        }
+    }
+    return range;
+}
+
+// Blue (cheap) to green to red (expensive).
+vec3 heatmap(float t)
+{
+    t = clamp(t, 0.0, 1.0);
+    return clamp(vec3(2.0 * t - 1.0, 1.0 - abs(2.0 * t - 1.0), 1.0 - 2.0 * t), 0.0, 1.0);
+}
+
+// March the fresh-pose ray through the given output UV, and
+// return the warped color. Also returns the hit, for passes that
+// resolve color later: hit.xy is the eye buffer UV the final color
+// comes from, hit.z the linear depth there, and hit.w how much of it
+// to blend over the color at warpUv (as with u_deferredColor).
+//
+// history is the previous warp's hitPoint at this pixel (only used
+// with u_useHistory). hitPoint is the world-space hit, with w = 1 if
+// it is good enough to be reused next time, or 0 if not.
+vec4 marchRay(vec2 warpUv, vec4 history, out vec4 hit, out vec4 hitPoint)
+{
+    float counter = 0.01;
+    int iter = 0;
+    int totalIter = 0;
+
+    vec4 V_worldspace = u_warpInverseVP * vec4(warpUv * 2.0 - 1.0, 1.0, 1);
+    vec4 marchingPoint_worldspace;
+    vec4 lastPoint_worldspace;
+
+    vec3 ndc;
+    vec3 ndc2;
+    float calcDepth;
+    float calcDepth2;
+    float lastDepth;
+    float lastStep;
+
+    float marchDepth, marchDepth2;
+
+    float accum = 0;
+    float delta;
+    float delta2;
+
+
+    vec4 color;
+
+    int iterations;
+    int hizSteps = 0;
+
+    // The same ray, in plain world space.
+    vec4 farPoint = u_warpInverseVP * vec4(warpUv * 2.0 - 1.0, 1.0, 1.0);
+    vec3 rayVector = farPoint.xyz / farPoint.w - u_warpPos;
+    float rayLength = length(rayVector);
+    vec3 rayDir = rayVector / rayLength;
+
+    // Distance along this ray closest to last warp's hit.
+    float historyDistance = dot(history.xyz - u_warpPos, rayDir);
+    bool reuse = u_useHistory && history.w > 0.0 && historyDistance > u_near && historyDistance < rayLength;
+
+    // Iteration budget of a full march, and where along V it starts.
+    int fullIterations = u_maxIterations;
+    float stepSize = u_stepSize;
+    float startK = 1.0;
+
+    if(u_adaptiveIterations) {
+        vec2 range = (marchDepthRange.y > 0.0) ? marchDepthRange : texelFetch(_HiZ, ivec2(0), u_hizMaxLevel).rg;
+        range.x = max(range.x, u_near);
+        range.y = max(range.y, range.x);
+
+        float parallax = u_parallaxScale * (1.0 / range.x - 1.0 / range.y);
+        fullIterations = clamp(u_minIterations + int(ceil(parallax * u_iterationsPerPixel)), 1, max(u_maxIterations, 1));
+
+        // Nothing is farther than range.y, so start there rather than at the
+        // far plane; and a step longer than the whole stretch of the ray
+        // between range.x and range.y can only overshoot. The march point
+        // (u_warpPos, 1) + V * k has linear depth (c0.w + k cV.w) / (1 + k V.w).
+        vec4 c0 = u_renderPV * vec4(u_warpPos, 1.0);
+        vec4 cV = u_renderPV * V_worldspace;
+        float kFar = (range.y - c0.w) / (cV.w - range.y * V_worldspace.w);
+        float kNear = (range.x - c0.w) / (cV.w - range.x * V_worldspace.w);
+        if(kFar > 0.0 && kFar < 1.0) {
+            startK = kFar;
+        }
+        if(kNear > 0.0 && kNear < startK) {
+            stepSize = min(stepSize, startK - kNear);
+        }
+    }
+
+    // At most two attempts: a short one from the reused hit, and
+    // a full march if that doesn't converge.
+    for(int attempt = 0; attempt < 2; attempt++) {
+        color = texture(Texture,warpUv);
+        marchingPoint_worldspace = vec4(u_warpPos,1) + V_worldspace * startK;
+        iterations = fullIterations;
+
+        if(reuse) {
+            marchingPoint_worldspace = vec4(u_warpPos + rayDir * historyDistance, 1.0);
+            iterations = u_historyIterations;
+        } else if(u_useHiZ) {
+            float s = traceHiZ(u_warpPos, rayDir, u_near, rayLength, hizSteps);
+            if(s >= 0.0) {
+                // Start the regular iterations at the hierarchical hit,
+                // and just use them to refine it.
+                marchingPoint_worldspace = vec4(u_warpPos + rayDir * s, 1.0);
+                iterations = u_hizRefineIterations;
+            }
+        }
+
+        // delta is needed for occlusion detection below, so always march at least once.
+        iterations = max(iterations, 1);
+
+        for(iter = 0; iter < iterations; iter++){
+
+            // We calculate the point in the old pose's NDC space.
+            // The march point is homogeneous; clip-space w over its w is its linear view depth.
+            vec4 clip = u_renderPV * marchingPoint_worldspace;
+            ndc = clip.xyz / clip.w;
+
+            calcDepth = sampleDepth((ndc.xy + 1.) * 0.5);
+            marchDepth = clip.w / marchingPoint_worldspace.w;
+
+            delta = calcDepth - marchDepth;
+
+            lastStep = clamp(delta * u_depthOffset, -stepSize, stepSize);
+            //lastStep = u_stepSize;
+            lastPoint_worldspace = marchingPoint_worldspace;
+            marchingPoint_worldspace += V_worldspace * lastStep;
+            lastDepth = calcDepth;
+            float factor = clamp(1-pow(abs(delta), u_power),0,1);
+            accum += factor;
+            if(!u_deferredColor) {
+                color = mix(color,texture(Texture,(ndc.xy + 1)*0.5),factor);
+            }
+
+            if(abs(delta) < u_convergenceThreshold) {
+                iter++;
+                break;
+            }
+        }
+
+        totalIter += iter;
+        if(!reuse || abs(delta) < u_historyTolerance) {
+            break;
+        }
+        // The reused hit didn't hold up; march again from scratch.
+        reuse = false;
+    }
+
+    float hitFactor = clamp(1-pow(abs(delta), u_power),0,1);
+    hit = vec4((ndc.xy + 1) * 0.5, calcDepth, hitFactor);
+
+    if(u_deferredColor) {
+        // Resolve color once, at the final hit.
+        color = mix(color,texture(Texture,hit.xy),hitFactor);
+    }
+
+    // Occlusion hole-filling.
+    float occlusionFactor = step(u_occlusionThreshold, abs(delta));
+    marchingPoint_worldspace -= V_worldspace * occlusionFactor * u_occlusionOffset;
+    ndc = ndcFromWorld(marchingPoint_worldspace, u_renderPV);
+    color = mix(color,texture(Texture,(ndc.xy + 1)*0.5),occlusionFactor);
+
+    if(occlusionFactor > 0.0) {
+        hit.xy = (ndc.xy + 1) * 0.5;
+        hit.z = sampleDepth(hit.xy);
+        hit.w = 1.0;
+    }
+
+    // Only converged, unoccluded hits are worth starting from next time.
+    float reusable = step(abs(delta), u_historyTolerance) * (1.0 - occlusionFactor);
+    hitPoint = vec4(lastPoint_worldspace.xyz / lastPoint_worldspace.w, reusable);
+
+    if(u_debugIterations) {
+        // Hierarchical steps are counted alongside the regular iterations.
+        return vec4(heatmap(float(totalIter + hizSteps) / float(max(u_maxIterations, 1))), 1.0);
+    }
+    return color;
+}
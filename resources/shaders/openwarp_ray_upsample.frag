@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+#version 450
+
+// Joint-bilateral upsample of the reduced-resolution raymarch.
+// Each output pixel looks at its four nearest low-resolution hits,
+// shifts each one by the pixel's offset from that hit's ray, and
+// weights it by how well the full-resolution depth there agrees with
+// the hit's depth. Hits from across a depth edge get little weight,
+// so edges stay sharp even though the rays were sparse.
+
+layout(binding = 1) uniform highp sampler2D Texture;
+layout(binding = 4) uniform highp sampler2D _LinearDepth;
+layout(binding = 5) uniform highp sampler2D _RayHits;
+
+// Size of the part of _RayHits that was marched.
+uniform ivec2 u_lowResSize;
+
+// Relative depth difference at which a hit's weight falls to 1/e.
+uniform mediump float u_depthSigma;
+
+in mediump vec2 warpNdc;
+out mediump vec4 outColor;
+
+void main()
+{
+    vec2 warpUv = warpNdc * 0.5 + 0.5;
+
+    vec2 lowResCoord = warpUv * vec2(u_lowResSize) - 0.5;
+    ivec2 base = ivec2(floor(lowResCoord));
+    vec2 f = fract(lowResCoord);
+
+    vec3 hitColor = vec3(0.0);
+    float hitFactor = 0.0;
+    float totalWeight = 0.0;
+
+    for(int i = 0; i < 4; i++) {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        ivec2 texel = clamp(base + offset, ivec2(0), u_lowResSize - 1);
+        vec4 hit = texelFetch(_RayHits, texel, 0);
+
+        // Nearby rays land nearby; move the hit by this pixel's
+        // offset from the ray it came from.
+        vec2 rayUv = (vec2(texel) + 0.5) / vec2(u_lowResSize);
+        vec2 uv = hit.xy + (warpUv - rayUv);
+
+        vec2 bilinear = mix(1.0 - f, f, vec2(offset));
+        float spatial = bilinear.x * bilinear.y;
+        float guide = texture(_LinearDepth, uv).r;
+        float range = exp(-abs(guide - hit.z) / (u_depthSigma * hit.z));
+
+        // Keep a trace of the spatial weight, so a pixel that
+        // disagrees with every hit still gets plain bilinear.
+        float weight = spatial * (range + 1e-3);
+
+        hitColor += texture(Texture, uv).rgb * weight;
+        hitFactor += hit.w * weight;
+        totalWeight += weight;
+    }
+
+    hitColor /= totalWeight;
+    hitFactor /= totalWeight;
+
+    outColor = vec4(mix(texture(Texture, warpUv).rgb, hitColor, hitFactor), 1.0);
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2020 Finn Sinclair.  All rights reserved.
+
+Developed by: Finn Sinclair
+              University of Illinois at Urbana-Champaign
+              finnsinclair.com
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal with
+the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to
+do so, subject to the following conditions:
+* Redistributions of source code must retain the above copyright notice,
+  this list of conditions and the following disclaimers.
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimers in the documentation
+  and/or other materials provided with the distribution.
+* Neither the names of Finn Sinclair, University of Illinois at Urbana-Champaign,
+  nor the names of its contributors may be used to endorse or promote products
+  derived from this Software without specific prior written permission.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS WITH THE
+SOFTWARE.
+*/
+
+#version 450
+
+// Resolves the forward-splatted UVs into color, and fills
+// any holes (disocclusions, gaps between splats).
+
+layout(binding = 1) uniform highp sampler2D Texture;
+
+layout(r32ui, binding = 0) uniform readonly uimage2D u_splatDepth;
+layout(rg32f, binding = 1) uniform readonly image2D u_splatUv;
+
+// Largest distance, in pixels, searched for a splat to fill a hole with.
+uniform int u_holeFillRadius;
+
+in mediump vec2 warpNdc;
+out mediump vec4 outColor;
+
+const uint EMPTY = 0xFFFFFFFFu;
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	ivec2 size = imageSize(u_splatDepth);
+
+	if(imageLoad(u_splatDepth, pixel).x != EMPTY) {
+		outColor = texture(Texture, imageLoad(u_splatUv, pixel).xy);
+		return;
+	}
+
+	// Hole. Search outwards ring by ring; in the first ring that has any
+	// splats, take the farthest one. Disocclusions reveal background, so
+	// the farthest neighbour is the best guess for what is behind.
+	uint bestDepth = 0u;
+	vec2 bestUv = warpNdc * 0.5 + 0.5;
+	bool found = false;
+
+	for(int r = 1; r <= u_holeFillRadius && !found; r++) {
+		for(int dy = -r; dy <= r; dy++) {
+			for(int dx = -r; dx <= r; dx++) {
+				if(max(abs(dx), abs(dy)) != r) {
+					continue;
+				}
+				ivec2 neighbour = pixel + ivec2(dx, dy);
+				if(any(lessThan(neighbour, ivec2(0))) || any(greaterThanEqual(neighbour, size))) {
+					continue;
+				}
+				uint depth = imageLoad(u_splatDepth, neighbour).x;
+				if(depth != EMPTY && depth >= bestDepth) {
+					bestDepth = depth;
+					// Continue the neighbour's surface across to this pixel.
+					bestUv = imageLoad(u_splatUv, neighbour).xy + vec2(pixel - neighbour) / vec2(size);
+					found = true;
+				}
+			}
+		}
+	}
+
+	outColor = texture(Texture, bestUv);
+}
@@ -22,7 +22,7 @@ using namespace Openwarp;
 
 OpenwarpApplication* OpenwarpApplication::instance;
 
-OpenwarpApplication::OpenwarpApplication(size_t meshSize){
+OpenwarpApplication::OpenwarpApplication(size_t meshSize, std::string meshCacheDir) : meshCacheDir(meshCacheDir) {
 
     // For static callbacks.
     OpenwarpApplication::instance = this;
@@ -44,6 +44,18 @@ OpenwarpApplication::OpenwarpApplication(size_t meshSize){
         glfwTerminate();
         abort();
     }
+
+    // The scene is rendered on a second context, sharing textures
+    // and buffers with the window's, so it can run on its own thread.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    renderContext = glfwCreateWindow(1, 1, "Openwarp render context", nullptr, window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if(!renderContext) {
+        std::cerr << "Failed to create render context." << std::endl;
+        glfwTerminate();
+        abort();
+    }
+
     glfwMakeContextCurrent(window);
     std::cout << "Application window successfully created...." << std::endl;
 
@@ -76,16 +88,15 @@ OpenwarpApplication::OpenwarpApplication(size_t meshSize){
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    // initGL builds the reprojection mesh at this size.
     meshWidth = meshHeight = meshSize;
-    // Adjust meshwarp bleed radius according to mesh size.
-    bleedRadius = (1.0f/(meshWidth));
 
     initGL();
 }
 
 
 
-void OpenwarpApplication::DoFullTestRun(const TestRun& testRun) {
+std::string OpenwarpApplication::createRunDir(const TestRun& testRun) {
 
     // Create desired output dir if it doesn't exist
     if(!fs::exists(testRun.outputDir)){
@@ -113,18 +124,142 @@ void OpenwarpApplication::DoFullTestRun(const TestRun& testRun) {
     info_file << origin_tag;
     info_file.close();
 
+    return runDir;
+}
+
+void OpenwarpApplication::DoFullTestRun(const TestRun& testRun, WarpAlgorithm testAlgorithm) {
+
+    std::string runDir = createRunDir(testRun);
+
     // Create the ground truth and warp directories
     fs::create_directory(runDir + "/warped");
     fs::create_directory(runDir + "/ground_truth");
 
     // Render and write reprojected frames
-    RunTest(testRun, runDir + "/warped", false, false);
+    RunTest(testRun, runDir + "/warped", false, testAlgorithm);
 
     // Render and write ground truth frames
-    RunTest(testRun, runDir + "/ground_truth", true, false);
+    RunTest(testRun, runDir + "/ground_truth", true, testAlgorithm);
+}
+
+void OpenwarpApplication::DoStereoTestRun(const TestRun& testRun, WarpAlgorithm synthAlgorithm) {
+
+    std::string runDir = createRunDir(testRun);
+    fs::create_directory(runDir + "/stereo_truth");
+    fs::create_directory(runDir + "/stereo_from_mono");
+
+    // For GL_RGB8
+    size_t frameBytes = WIDTH * HEIGHT * 3;
+    GLubyte* truth_data = (GLubyte*)malloc(frameBytes);
+    GLubyte* synth_data = (GLubyte*)malloc(frameBytes);
+
+    // Need to flip vertically.
+    stbi_flip_vertically_on_write(1);
+
+    // Same conditions as RunTest: in line, at exactly the test poses.
+    joinRenderThread();
+    selectPoseProvider(false);
+
+    // The late latch would swap in a newer pose in the middle of the warp.
+    useLateLatch = false;
+
+    predictionMode = PredictionMode::None;
+    stallInjector.Configure(StallSettings());
+    if(useGovernor) {
+        useGovernor = false;
+        applyQualityLevel(userQuality);
+    }
+    useStereo = true;
+
+    std::ofstream quality_file(runDir + "/stereo_quality.csv");
+    quality_file << "x,y,z,psnr_db,stereo_scene_ms,mono_scene_ms,mono_depth_prep_ms" << std::endl;
+
+    double psnrSum = 0.0;
+    double stereoSceneMsSum = 0.0;
+    double monoSceneMsSum = 0.0;
+    double monoDepthPrepMsSum = 0.0;
+    size_t numFrames = 0;
+
+    for (auto &test : testRun) {
+        inputPoseProvider.Push(glfwGetTime(), test.position, test.orientation);
+
+        glfwPollEvents();
+        if(glfwWindowShouldClose(window)){
+            break;
+        }
+
+        // Both eyes rendered, and shown as they are.
+        stereoFromMono = false;
+        double stereoSceneMs = 0.0;
+        uint64_t stereoFrame = 0;
+        runOnRenderContext([this, &stereoSceneMs, &stereoFrame]{
+            stereoFrame = renderEyeBuffer();
+            sceneTimer.Finish();
+            stereoSceneMs = sceneTimer.lastMs;
+        });
+        presentEyeBuffer(stereoFrame);
+        glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, truth_data);
+
+        // The centre view rendered at the same pose, and both eyes warped from it.
+        stereoFromMono = true;
+        double monoSceneMs = 0.0;
+        double monoDepthPrepMs = 0.0;
+        uint64_t monoFrame = 0;
+        runOnRenderContext([this, &monoSceneMs, &monoDepthPrepMs, &monoFrame]{
+            monoFrame = renderEyeBuffer();
+            sceneTimer.Finish();
+            depthPrepTimer.Finish();
+            monoSceneMs = sceneTimer.lastMs;
+            monoDepthPrepMs = depthPrepTimer.lastMs;
+        });
+        doReprojection(synthAlgorithm, monoFrame);
+        glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, synth_data);
+
+        double squaredError = 0.0;
+        for(size_t i = 0; i < frameBytes; i++) {
+            double difference = (double)truth_data[i] - (double)synth_data[i];
+            squaredError += difference * difference;
+        }
+        double mse = squaredError / frameBytes;
+        double psnr = mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 100.0;
+
+        std::string tag = std::to_string(test.relative_pos[0]) + "_"
+                        + std::to_string(test.relative_pos[1]) + "_"
+                        + std::to_string(test.relative_pos[2]);
+        stbi_write_png((runDir + "/stereo_truth/" + tag + ".png").c_str(), WIDTH, HEIGHT, 3, truth_data, WIDTH * sizeof(GLubyte) * 3);
+        stbi_write_png((runDir + "/stereo_from_mono/" + tag + ".png").c_str(), WIDTH, HEIGHT, 3, synth_data, WIDTH * sizeof(GLubyte) * 3);
+
+        quality_file << test.relative_pos[0] << "," << test.relative_pos[1] << "," << test.relative_pos[2] << ","
+                     << psnr << "," << stereoSceneMs << "," << monoSceneMs << "," << monoDepthPrepMs << std::endl;
+        std::cout << tag << ": PSNR " << psnr << " dB" << std::endl;
+
+        psnrSum += psnr;
+        stereoSceneMsSum += stereoSceneMs;
+        monoSceneMsSum += monoSceneMs;
+        monoDepthPrepMsSum += monoDepthPrepMs;
+        numFrames++;
+
+        glfwSwapBuffers(window);
+    }
+    quality_file.close();
+
+    if(numFrames > 0) {
+        double stereoSceneMs = stereoSceneMsSum / numFrames;
+        double monoSceneMs = monoSceneMsSum / numFrames;
+        std::cout << "Stereo from mono (" << WarpAlgorithmName(synthAlgorithm) << "): mean PSNR "
+                  << psnrSum / numFrames << " dB against true stereo over " << numFrames << " poses." << std::endl;
+        std::cout << "Scene GPU time: " << stereoSceneMs << " ms stereo, " << monoSceneMs << " ms mono ("
+                  << (stereoSceneMs > 0.0 ? 100.0 * (1.0 - monoSceneMs / stereoSceneMs) : 0.0) << "% saved)." << std::endl;
+        std::cout << "Mono depth preparation for the warp: " << monoDepthPrepMsSum / numFrames << " ms more." << std::endl;
+    }
+
+    stereoFromMono = false;
+    useStereo = false;
+    free(truth_data);
+    free(synth_data);
 }
 
-void OpenwarpApplication::RunTest(const TestRun& testRun, std::string runDir, bool isGroundTruth, bool testUsesRay){
+void OpenwarpApplication::RunTest(const TestRun& testRun, std::string runDir, bool isGroundTruth, WarpAlgorithm testAlgorithm){
 
     // For GL_RGB8
     GLubyte* fb_data = (GLubyte*)malloc(WIDTH * HEIGHT * 3);
@@ -132,23 +267,45 @@ void OpenwarpApplication::RunTest(const TestRun& testRun, std::string runDir, bo
     // Need to flip vertically.
     stbi_flip_vertically_on_write(1);
 
-    // shouldReproject = true makes renderScene draw to renderFBO.
-    // shouldReproject = false makes renderScene draw to screen.
-    
-    if(isGroundTruth) {
-        shouldReproject = false;
-    } else {
+    // Test runs render in line, on this thread, at exactly the test poses;
+    // nothing is predicted or re-sampled.
+    joinRenderThread();
+    selectPoseProvider(false);
+
+    // The late latch would swap in a newer pose in the middle of the warp.
+    useLateLatch = false;
+
+    predictionMode = PredictionMode::None;
+    stallInjector.Configure(StallSettings());
+    if(useGovernor) {
+        useGovernor = false;
+        applyQualityLevel(userQuality);
+    }
+    useStereo = false;
+
+    // Every warp and blit names the frame it's of, so none of them can
+    // pick up a frame that's still rendering, or one from an earlier run.
+    uint64_t startFrame = 0;
+    if(!isGroundTruth) {
         // If not the ground truth run, we render once
         // so that the reprojection has something to use.
-        position = testRun.startPose.position;
-        orientation = testRun.startPose.orientation;
-        shouldReproject = true;
-        renderScene();
+        inputPoseProvider.Push(glfwGetTime(), testRun.startPose.position, testRun.startPose.orientation);
+        runOnRenderContext([this, &startFrame]{ startFrame = renderEyeBuffer(); });
+
+        // The plane fit is asynchronous; wait for the start frame's here
+        // so the planar test run is deterministic.
+        if(testAlgorithm == WarpAlgorithm::Planar && startFrame != 0) {
+            for(int i = 0; i < NUM_EYE_BUFFERS; i++) {
+                GLsync planeFitFence = eyeBuffers[i].plane_fit_fence;
+                if(eyeBuffers[i].frame_id == startFrame && planeFitFence) {
+                    glClientWaitSync(planeFitFence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                }
+            }
+        }
     }
 
     for (auto &test : testRun) {
-        position = test.position;
-        orientation = test.orientation;
+        inputPoseProvider.Push(glfwGetTime(), test.position, test.orientation);
 
         glfwPollEvents();
         if(glfwWindowShouldClose(window)){
@@ -156,10 +313,13 @@ void OpenwarpApplication::RunTest(const TestRun& testRun, std::string runDir, bo
         }
 
         // Render
-        if (isGroundTruth)
-            renderScene();
-        else
-            doReprojection(testUsesRay);
+        if (isGroundTruth) {
+            uint64_t frame = 0;
+            runOnRenderContext([this, &frame]{ frame = renderEyeBuffer(); });
+            presentEyeBuffer(frame);
+        } else {
+            doReprojection(testAlgorithm, startFrame);
+        }
 
         // Read pixels out from the screen.
         glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, fb_data);
@@ -176,41 +336,412 @@ void OpenwarpApplication::RunTest(const TestRun& testRun, std::string runDir, bo
 }
 
 void OpenwarpApplication::Run(bool showGUI){
+    if(useRenderThread) {
+        startRenderThread();
+    }
+
+    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    vsyncScheduler.Reset(mode ? mode->refreshRate : 60.0);
+    framePacer.Reset(mode ? mode->refreshRate : 60.0);
+    beamRacer.Reset(mode ? mode->refreshRate : 60.0, glfwGetTime());
+    bool wasScheduled = false;
+
     while(!glfwWindowShouldClose(window)) {
 
+        // Sleep until the warp is due, then sample input; the warp's cost
+        // is taken from the GPU timer, and the rest of the frame's is measured.
+        bool scheduled = useVsync && useWarpScheduler;
+        if(scheduled && !wasScheduled) {
+            vsyncScheduler.Reset(1.0 / vsyncScheduler.Period());
+        }
+        if(scheduled) {
+            PreciseSleepUntil(vsyncScheduler.FrameStartTime(glfwGetTime(), warpTimer.averageMs));
+        }
+        wasScheduled = scheduled;
+
+        // Nothing else paces the loop with vsync off. The beam racer
+        // keeps to its own virtual refresh.
+        bool beamRacing = useBeamRacing && !useStereo;
+        framePacer.SetMode(pacingMode);
+        if(!useVsync && !beamRacing && pacingMode != PacingMode::Spin) {
+            framePacer.WaitForFrame();
+        }
+        double frameStartTime = glfwGetTime();
+
         glfwPollEvents();
         imgui_io = ImGui::GetIO();
         
         processInput();
 
-        // If it's time to render a frame (based on the desired render frequency)
-        // we render, and increment the next render time.
-        if(glfwGetTime() >= nextRenderTime){
+        // Without the render thread, we render in line: if it's time to
+        // render a frame (based on the desired render frequency) we render,
+        // and increment the next render time. A slow render then holds
+        // up the warp, and the presentation framerate drops with it.
+        if(!renderThread.joinable() && glfwGetTime() >= nextRenderTime){
             
             if(shouldRenderScene) {
-                renderScene();
+                runOnRenderContext([this]{ renderEyeBuffer(); });
             }
             
             nextRenderTime += renderInterval;
             
         }
 
-        // Reproject every frame.
-        // If we've already rendered this frame, this
-        // will not reproject. This is because we don't resample
-        // user input before reprojection; in an XR application,
-        // you would resample user pose every time before reprojection
-        // for the most up-to-date pose.
-        if (shouldReproject)
-            doReprojection(useRay);
+        // Reproject every frame, from the newest finished eye buffer
+        // to the pose we just sampled. Unless neither has changed since
+        // the last warp (and nobody is dragging a slider), in which case
+        // that is shown again.
+        PoseSample pose;
+        poseProvider.load()->History().Latest(pose);
+        bool skipWarp = pacingMode == PacingMode::SkipUnchanged && shouldReproject
+                        && !(showGUI && ImGui::IsAnyItemActive())
+                        && !framePacer.NeedsWarp(pose, newestFrameId(), glfwGetTime());
+        if (skipWarp) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, lastWarpFBO);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        } else if (shouldReproject) {
+            if(beamRacing) {
+                doBeamRacedWarp(warpAlgorithm);
+            } else {
+                doReprojection(warpAlgorithm);
+            }
+
+            // Keep it, before the GUI is drawn over it.
+            if(pacingMode == PacingMode::SkipUnchanged) {
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+                glBindFramebuffer(GL_DRAW_FRAMEBUFFER, lastWarpFBO);
+                glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            }
+        } else {
+            presentEyeBuffer();
+        }
 
         if(showGUI)
             drawGUI();
+
+        if(scheduled) {
+            vsyncScheduler.FrameSubmitted(frameStartTime, glfwGetTime());
+        }
         
         glfwSwapBuffers(window);
+
+        // Wait for the flip itself, so the time the swap completes
+        // tracks the vsync rather than when the driver queued it.
+        if(scheduled) {
+            glFinish();
+            vsyncScheduler.FramePresented(glfwGetTime());
+        }
+
+        // Measure how long after its pose was sampled each frame
+        // first reaches the screen, to predict the render pose that far ahead.
+        if(warpedFrameId != latencyFrameId) {
+            latencyFrameId = warpedFrameId;
+            double latency = glfwGetTime() - warpedFrameTime;
+            renderPhotonLatency = renderPhotonLatency.load() * 0.9 + latency * 0.1;
+        } else {
+            reusedFrameCount++;
+        }
+        presentedFrameCount++;
+        double presentedAge = 1000.0 * (glfwGetTime() - warpedFrameTime);
+        presentedAgeMs = (presentedFrameCount == 1) ? presentedAge : presentedAgeMs * 0.95 + presentedAge * 0.05;
+
         presentationFramerate = 1.0/(glfwGetTime() - lastSwapTime);
         lastSwapTime = glfwGetTime();
+
+        if(skipWarp) {
+            framePacer.FrameSkipped(lastSwapTime);
+        } else {
+            // Beam-raced frames bypass warpTimer; their slices are timed instead.
+            double warpMs = !shouldReproject ? 0.0 : beamRacing ? beamRacer.FrameCostMs() : warpTimer.lastMs;
+            framePacer.FrameWarped(pose, warpedFrameId, lastSwapTime, warpMs);
+        }
+    }
+
+    joinRenderThread();
+}
+
+void OpenwarpApplication::startRenderThread(){
+    if(renderThread.joinable()) {
+        return;
+    }
+
+    // Don't try to catch up on frames missed while paused.
+    nextRenderTime = std::max(nextRenderTime, glfwGetTime());
+
+    stopRenderThread = false;
+    renderThread = std::thread(&OpenwarpApplication::renderLoop, this);
+}
+
+void OpenwarpApplication::joinRenderThread(){
+    if(!renderThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(eyeBufferMutex);
+        stopRenderThread = true;
+    }
+    eyeBufferCondition.notify_all();
+    renderThread.join();
+    stopRenderThread = false;
+}
+
+void OpenwarpApplication::renderLoop(){
+    glfwMakeContextCurrent(renderContext);
+
+    std::unique_lock<std::mutex> lock(eyeBufferMutex);
+    while(!stopRenderThread) {
+        double wait = nextRenderTime - glfwGetTime();
+        if(wait > 0) {
+            eyeBufferCondition.wait_for(lock, std::chrono::duration<double>(wait));
+            continue;
+        }
+
+        lock.unlock();
+        if(shouldRenderScene) {
+            renderEyeBuffer();
+        }
+        nextRenderTime += renderInterval;
+        lock.lock();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+void OpenwarpApplication::runOnRenderContext(const std::function<void()>& fn){
+    bool wasRunning = renderThread.joinable();
+    joinRenderThread();
+
+    glfwMakeContextCurrent(renderContext);
+    fn();
+    glfwMakeContextCurrent(window);
+
+    if(wasRunning) {
+        startRenderThread();
+    }
+}
+
+int OpenwarpApplication::newestEyeBuffer() const {
+    int newest = -1;
+    for(int i = 0; i < NUM_EYE_BUFFERS; i++) {
+        if(eyeBuffers[i].state == EyeBufferState::Ready &&
+            (newest < 0 || eyeBuffers[i].frame_id > eyeBuffers[newest].frame_id)) {
+            newest = i;
+        }
+    }
+    return newest;
+}
+
+uint64_t OpenwarpApplication::newestFrameId(){
+    std::lock_guard<std::mutex> lock(eyeBufferMutex);
+    int newest = newestEyeBuffer();
+    return newest < 0 ? 0 : eyeBuffers[newest].frame_id;
+}
+
+int OpenwarpApplication::acquireRenderTarget(){
+    std::unique_lock<std::mutex> lock(eyeBufferMutex);
+
+    // Anything but the one being warped, and the newest frame (which the
+    // warp will move on to next). Prefer free ones, then the oldest frame.
+    int target = -1;
+    auto findTarget = [&]{
+        int newest = newestEyeBuffer();
+        target = -1;
+        for(int i = 0; i < NUM_EYE_BUFFERS; i++) {
+            const owEyeBuffer& eye = eyeBuffers[i];
+            if(i == warpingEyeBuffer || i == newest) {
+                continue;
+            }
+            if(eye.state == EyeBufferState::Free) {
+                target = i;
+                return true;
+            }
+            if(target < 0 || eye.frame_id < eyeBuffers[target].frame_id) {
+                target = i;
+            }
+        }
+        return target >= 0;
+    };
+
+    // Only runs dry with fewer than three eye buffers.
+    if(!findTarget()) {
+        renderStallCount++;
+        eyeBufferCondition.wait(lock, [&]{ return stopRenderThread || findTarget(); });
+    }
+    if(stopRenderThread) {
+        return -1;
+    }
+    eyeBuffers[target].state = EyeBufferState::Rendering;
+    return target;
+}
+
+uint64_t OpenwarpApplication::renderEyeBuffer(){
+    // Emulate a struggling application, if asked to.
+    StallPlan stall = stallInjector.Next();
+    if(stall.drop) {
+        return 0;
+    }
+
+    int target = acquireRenderTarget();
+    if(target < 0) {
+        return 0;
+    }
+    owEyeBuffer& eye = eyeBuffers[target];
+
+    // Don't overwrite it before the GPU is done warping from it.
+    if(eye.warp_fence) {
+        glWaitSync(eye.warp_fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(eye.warp_fence);
+        eye.warp_fence = 0;
+    }
+
+    // Render at the pose predicted for when this frame will first be seen.
+    eye.render_time = glfwGetTime();
+    eye.camera_matrix = predictedCameraMatrix(renderPredictor, eye.render_time + renderPhotonLatency);
+
+    // Stereo from mono renders just the centre view; the warp makes the eyes.
+    eye.stereo = useStereo && !stereoFromMono;
+    if(eye.stereo) {
+        renderStereoScene(eye);
+    } else {
+        renderScene(eye);
+    }
+    sceneGpuMs = sceneTimer.averageMs;
+    depthPrepGpuMs = depthPrepTimer.averageMs;
+
+    if(stall.gpuMs > 0.0) {
+        burnGpuTime(stall.gpuMs);
+    }
+    if(stall.cpuMs > 0.0) {
+        PreciseSleepUntil(glfwGetTime() + stall.cpuMs / 1000.0);
+    }
+
+    if(eye.render_fence) {
+        glDeleteSync(eye.render_fence);
+    }
+    eye.render_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // The warp waits on the fence from the other context,
+    // which only works once it has been flushed.
+    glFlush();
+
+    std::lock_guard<std::mutex> lock(eyeBufferMutex);
+    eye.frame_id = nextFrameId++;
+    eye.state = EyeBufferState::Ready;
+    return eye.frame_id;
+}
+
+bool OpenwarpApplication::acquireWarpSource(uint64_t frameId){
+    std::unique_lock<std::mutex> lock(eyeBufferMutex);
+
+    int source = -1;
+    if(frameId != 0) {
+
+        // Exactly the frame asked for, finished or not.
+        for(int i = 0; i < NUM_EYE_BUFFERS; i++) {
+            if(eyeBuffers[i].state == EyeBufferState::Ready && eyeBuffers[i].frame_id == frameId) {
+                source = i;
+            }
+        }
+        if(source < 0) {
+            return false;
+        }
+
+    } else {
+
+        // Newest frame the GPU has finished. The renderer only touches a
+        // fence after taking its eye buffer, so polling it here is safe.
+        for(int i = 0; i < NUM_EYE_BUFFERS; i++) {
+            const owEyeBuffer& eye = eyeBuffers[i];
+            if(eye.state != EyeBufferState::Ready ||
+                (source >= 0 && eye.frame_id < eyeBuffers[source].frame_id)) {
+                continue;
+            }
+            GLenum status = glClientWaitSync(eye.render_fence, 0, 0);
+            if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                source = i;
+            }
+        }
+    }
+
+    // Nothing finished yet; fall back to the newest frame, and wait for it on the GPU.
+    if(source < 0) {
+        source = newestEyeBuffer();
+    }
+    if(source < 0) {
+        return false;
+    }
+    warpingEyeBuffer = source;
+    lock.unlock();
+
+    // The render thread won't touch this eye buffer
+    // until we release it, so no need to hold the lock.
+    owEyeBuffer& eye = eyeBuffers[warpingEyeBuffer];
+    renderTexture = eye.color_texture;
+    depthTexture = eye.depth_texture;
+    linearDepthTexture = eye.linear_depth_texture;
+    hizTexture = eye.hiz_texture;
+    renderedCameraMatrix = eye.camera_matrix;
+    warpingStereo = eye.stereo;
+    stereoColorArray = eye.stereo_color_array;
+    stereoDepthArray = eye.stereo_depth_array;
+    for(int e = 0; e < NUM_EYES; e++) {
+        renderedEyeCameraMatrix[e] = eye.eye_camera_matrix[e];
+    }
+    warpedFrameId = eye.frame_id;
+    warpedFrameTime = eye.render_time;
+
+    glWaitSync(eye.render_fence, 0, GL_TIMEOUT_IGNORED);
+    return true;
+}
+
+void OpenwarpApplication::releaseWarpSource(){
+    owEyeBuffer& eye = eyeBuffers[warpingEyeBuffer];
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    {
+        std::lock_guard<std::mutex> lock(eyeBufferMutex);
+        if(eye.warp_fence) {
+            glDeleteSync(eye.warp_fence);
+        }
+        eye.warp_fence = fence;
+        warpingEyeBuffer = -1;
+    }
+    eyeBufferCondition.notify_all();
+}
+
+void OpenwarpApplication::presentEyeBuffer(uint64_t frameId){
+    if(!acquireWarpSource(frameId)) {
+        return;
+    }
+
+    if(warpingStereo) {
+        presentStereo(stereoColorArray);
+        releaseWarpSource();
+        return;
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, presentFBO);
+    glFramebufferTexture(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, renderTexture, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    releaseWarpSource();
+}
+
+void OpenwarpApplication::presentStereo(GLuint colorArray){
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, presentFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    for(int e = 0; e < NUM_EYES; e++) {
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, colorArray, 0, e);
+        glBlitFramebuffer(0, 0, EYE_WIDTH, HEIGHT, e * EYE_WIDTH, 0, (e + 1) * EYE_WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
     }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void OpenwarpApplication::drawGUI(){
@@ -220,7 +751,7 @@ void OpenwarpApplication::drawGUI(){
     
     if(showMeshConfig) {
         ImGui::SetNextWindowPos(ImVec2(0, 1024), ImGuiCond_Once, ImVec2(0.0f, 1.0f));
-        ImGui::SetNextWindowSize(ImVec2(300,250), ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImVec2(300,300), ImGuiCond_Always);
         
         ImGui::Begin("Mesh configuration", &showMeshConfig, ImGuiWindowFlags_NoResize);
         if (ImGui::CollapsingHeader("Edge bleed options", ImGuiTreeNodeFlags_DefaultOpen)){
@@ -231,6 +762,33 @@ void OpenwarpApplication::drawGUI(){
             ImGui::SliderFloat("##2", &bleedTolerance, 0.0f, 0.05f);
             ImGui::PopItemWidth();
         }
+        if (ImGui::CollapsingHeader("Mesh resolution", ImGuiTreeNodeFlags_DefaultOpen)){
+            ImGui::PushItemWidth(-1);
+            std::string currentSize = std::to_string(meshWidth) + " x " + std::to_string(meshHeight);
+            if (ImGui::BeginCombo("##meshsize", currentSize.c_str())) {
+                // Powers of two, plus the current size (-mesh takes any).
+                std::vector<size_t> sizes;
+                for (size_t size = minMeshSize; size <= maxMeshSize; size *= 2) {
+                    sizes.push_back(size);
+                }
+                if (std::find(sizes.begin(), sizes.end(), meshWidth) == sizes.end()) {
+                    sizes.insert(std::upper_bound(sizes.begin(), sizes.end(), meshWidth), meshWidth);
+                }
+                for (size_t size : sizes) {
+                    std::string label = std::to_string(size) + " x " + std::to_string(size);
+                    bool isCached = std::any_of(meshCache.begin(), meshCache.end(),
+                                                [size](const owMeshBuffers& mesh){ return mesh.width == size && mesh.height == size; });
+                    if (isCached) {
+                        label += " (cached)";
+                    }
+                    if (ImGui::Selectable(label.c_str(), size == meshWidth && size == meshHeight)) {
+                        SetMeshSize(size);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            ImGui::PopItemWidth();
+        }
         ImGui::Checkbox("Show grid debug overlay", &showDebugGrid);
     
         ImGui::End();
@@ -238,7 +796,7 @@ void OpenwarpApplication::drawGUI(){
 
     if(showRayConfig) {
         ImGui::SetNextWindowPos(ImVec2(300, 1024), ImGuiCond_Once, ImVec2(0.0f, 1.0f));
-        ImGui::SetNextWindowSize(ImVec2(300,250), ImGuiCond_Always);
+        ImGui::SetNextWindowSize(ImVec2(300,760), ImGuiCond_Always);
         
         ImGui::Begin("Raymarch configuration", &showRayConfig, ImGuiWindowFlags_NoResize);
         ImGui::Text("Ray exponent power");
@@ -247,16 +805,281 @@ void OpenwarpApplication::drawGUI(){
         ImGui::Text("Ray step size");
         ImGui::SliderFloat("##2", &rayStepSize, 0.0f, 5.0f);
         ImGui::Text("Ray depth offset");
-        ImGui::SliderFloat("##3", &rayDepthOffset, 0.0f, 2.0f);
+        ImGui::SliderFloat("##3", &rayDepthOffset, 0.0f, 4.0f);
         ImGui::Text("Occlusion detection threshold");
         ImGui::SliderFloat("##4", &occlusionThreshold, 0.0f, 0.03f);
         ImGui::Text("Occlusion offset");
         ImGui::SliderFloat("##5", &occlusionOffset, 0.0f, 1.0f);
         ImGui::PopItemWidth();
+        if (ImGui::CollapsingHeader("Iteration budget", ImGuiTreeNodeFlags_DefaultOpen)){
+            ImGui::Text("Max iterations");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderInt("##7", &rayMaxIterations, 1, 64);
+            ImGui::Text("Convergence threshold (0 = off)");
+            ImGui::SliderFloat("##8", &rayConvergenceThreshold, 0.0f, 0.01f, "%.4f");
+            ImGui::PopItemWidth();
+            ImGui::Checkbox("Adapt to pose delta", &rayAdaptiveIterations);
+            if (rayAdaptiveIterations) {
+                ImGui::Text("Min iterations");
+                ImGui::PushItemWidth(-1);
+                ImGui::SliderInt("##12", &rayMinIterations, 1, 32);
+                ImGui::Text("Iterations per pixel of parallax");
+                ImGui::SliderFloat("##13", &rayIterationsPerPixel, 0.0f, 2.0f);
+                ImGui::PopItemWidth();
+                ImGui::Checkbox("Per tile (compute-shader tiles)", &rayAdaptivePerTile);
+            }
+            ImGui::Checkbox("Resolve color at final hit only", &rayDeferredColor);
+            ImGui::Checkbox("Show iteration count heatmap", &rayDebugIterations);
+        }
+        ImGui::Checkbox("Compute-shader tiles", &rayUseCompute);
+        if (ImGui::Checkbox("Reuse last warp's hits", &rayUseHistory) && rayUseHistory) {
+            // Anything left over is from an unrelated warp.
+            glClearTexImage(rayHistoryTexture, 0, GL_RGBA, GL_FLOAT, NULL);
+        }
+        if (rayUseHistory) {
+            ImGui::Text("Reuse refinement iterations");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderInt("##10", &rayHistoryIterations, 1, 8);
+            ImGui::Text("Reuse tolerance");
+            ImGui::SliderFloat("##11", &rayHistoryTolerance, 0.001f, 0.1f, "%.3f");
+            ImGui::PopItemWidth();
+        }
+        ImGui::Text("March resolution");
+        ImGui::RadioButton("Full", &rayResolutionDivisor, 1);
+        ImGui::SameLine();
+        ImGui::RadioButton("Half", &rayResolutionDivisor, 2);
+        ImGui::SameLine();
+        ImGui::RadioButton("Quarter", &rayResolutionDivisor, 4);
+        if (rayResolutionDivisor > 1) {
+            ImGui::Text("Upsample depth sigma");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderFloat("##9", &rayUpsampleDepthSigma, 0.001f, 0.2f, "%.3f");
+            ImGui::PopItemWidth();
+        }
+        ImGui::Checkbox("Hierarchical (Hi-Z) tracing", &rayUseHiZ);
+        if (rayUseHiZ) {
+            ImGui::Text("Hi-Z refinement iterations");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderInt("##6", &rayHiZRefineIterations, 0, 16);
+            ImGui::PopItemWidth();
+        }
     
         ImGui::End();
     }
 
+    if(showReprojectionConfig) {
+        ImGui::SetNextWindowPos(ImVec2(600, 1024), ImGuiCond_Once, ImVec2(0.0f, 1.0f));
+        ImGui::SetNextWindowSize(ImVec2(300,450), ImGuiCond_Always);
+
+        ImGui::Begin("Reprojection configuration", &showReprojectionConfig, ImGuiWindowFlags_NoResize);
+        if (ImGui::CollapsingHeader("Algorithm", ImGuiTreeNodeFlags_DefaultOpen)){
+            for (int i = 0; i < (int)WarpAlgorithm::Count; i++) {
+                if (ImGui::RadioButton(WarpAlgorithmName((WarpAlgorithm)i), warpAlgorithm == (WarpAlgorithm)i)) {
+                    warpAlgorithm = (WarpAlgorithm)i;
+                    budgetFallbackActive = false;
+                }
+            }
+            if (ImGui::Checkbox("Half-precision linear depth", &linearDepthHalfFloat)) {
+                // The old contents are lost; redo them from the rendered frames.
+                runOnRenderContext([this]{
+                    for(auto& eye : eyeBuffers) {
+                        createLinearDepthTexture(eye);
+                        linearizeDepth(eye);
+                        buildHiZ(eye);
+                    }
+                    // The warp reads these from the other context straight away.
+                    glFinish();
+                });
+            }
+            ImGui::Checkbox("Late-latch the warp pose", &useLateLatch);
+            bool threaded = renderThread.joinable();
+            if (ImGui::Checkbox("Render on a separate thread", &threaded)) {
+                useRenderThread = threaded;
+                if (threaded) {
+                    startRenderThread();
+                } else {
+                    joinRenderThread();
+                }
+            }
+        }
+        if (ImGui::CollapsingHeader("Stereo")){
+            bool stereo = useStereo;
+            if (ImGui::Checkbox("Render and warp both eyes", &stereo)) {
+                useStereo = stereo;
+                SetMeshSize(meshWidth);
+            }
+            bool fromMono = stereoFromMono;
+            if (ImGui::Checkbox("Synthesize both eyes from a centre view", &fromMono)) {
+                stereoFromMono = fromMono;
+            }
+            ImGui::Text("IPD");
+            ImGui::PushItemWidth(-1);
+            float eyeIpd = ipd;
+            ImGui::SliderFloat("##ipd", &eyeIpd, 0.0f, 0.1f, "%.3f m");
+            ipd = eyeIpd;
+            ImGui::PopItemWidth();
+            const char* paths[] = { "single pass (multiview)", "single pass (layered)", "a pass per eye" };
+            if (stereoFromMono) {
+                ImGui::Text("A %s warp per eye", warpAlgorithm == WarpAlgorithm::Ray ? "ray" : "mesh");
+            } else {
+                ImGui::Text("Mesh warp only; %s", paths[(int)stereoProgram.path]);
+            }
+        }
+        if (ImGui::CollapsingHeader("Hybrid options")){
+            ImGui::Text("Discontinuity threshold");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderFloat("##discontinuity", &hybridDiscontinuityThreshold, 0.0f, 0.5f, "%.3f");
+            ImGui::PopItemWidth();
+            ImGui::Checkbox("Highlight raymarched tiles", &hybridShowTiles);
+        }
+        if (ImGui::CollapsingHeader("Forward splat options")){
+            ImGui::Text("Splat size (pixels)");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderInt("##splatsize", &splatSize, 1, 4);
+            ImGui::Text("Hole fill radius (pixels)");
+            ImGui::SliderInt("##holefill", &splatHoleFillRadius, 0, 16);
+            ImGui::PopItemWidth();
+        }
+        if (ImGui::CollapsingHeader("Planar options", ImGuiTreeNodeFlags_DefaultOpen)){
+            ImGui::Checkbox("Fit plane to depth buffer", &planarUseFittedPlane);
+            ImGui::Text("Focal distance");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderFloat("##focal", &planarFocalDistance, 0.1f, 20.0f);
+            ImGui::PopItemWidth();
+        }
+        if (ImGui::CollapsingHeader("Frame budget", ImGuiTreeNodeFlags_DefaultOpen)){
+            ImGui::Text("Warp budget (ms)");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderFloat("##budget", &warpBudgetMs, 0.1f, 16.0f);
+            ImGui::PopItemWidth();
+            if (ImGui::Checkbox("Adaptive quality governor", &useGovernor) && useGovernor) {
+                userQuality = {"User", warpAlgorithm, meshWidth, rayMaxIterations, rayResolutionDivisor};
+                governor.SetLevel(0);
+                applyQualityLevel(governor.Current());
+            }
+            if (useGovernor) {
+                ImGui::Text("Level %zu/%zu: %s", governor.Level() + 1, governor.NumLevels(), governor.Current().name);
+            } else {
+                ImGui::Checkbox("Fall back to planar over budget", &useBudgetFallback);
+            }
+        }
+        if (ImGui::CollapsingHeader("Stall injection")){
+            StallSettings stall = stallInjector.Settings();
+            int mode = (int)stall.mode;
+            ImGui::PushItemWidth(-1);
+            ImGui::Combo("##stallmode", &mode, "None\0Fixed cost\0Periodic spikes\0Random drops\0Recorded profile\0");
+            stall.mode = (StallMode)mode;
+            switch(stall.mode) {
+                case StallMode::Fixed:
+                    ImGui::SliderFloat("##stallextra", &stall.extraMs, 0.0f, 100.0f, "Extra %.1f ms");
+                    break;
+                case StallMode::Spikes:
+                    ImGui::SliderFloat("##stallspike", &stall.spikeMs, 0.0f, 500.0f, "Spike %.1f ms");
+                    ImGui::SliderInt("##stallperiod", &stall.spikePeriod, 1, 300, "Every %d frames");
+                    break;
+                case StallMode::RandomDrops:
+                    ImGui::SliderFloat("##stalldrop", &stall.dropChance, 0.0f, 1.0f, "Drop %.2f of frames");
+                    break;
+                case StallMode::Recorded:
+                    ImGui::SliderFloat("##stallbaseline", &stall.baselineMs, 0.0f, 50.0f, "Baseline %.1f ms");
+                    break;
+                default:
+                    break;
+            }
+            ImGui::PopItemWidth();
+            if(stall.mode == StallMode::Recorded) {
+                ImGui::Text("%zu recorded frame times", stallInjector.ProfileSize());
+            }
+            if(stall.mode != StallMode::RandomDrops) {
+                ImGui::Checkbox("Spend it on the GPU", &stall.onGpu);
+            }
+            stallInjector.Configure(stall);
+            ImGui::Text("Stalled %llu, dropped %llu of %llu",
+                        (unsigned long long)stallInjector.Stalled(), (unsigned long long)stallInjector.Dropped(),
+                        (unsigned long long)stallInjector.Frames());
+        }
+        if (ImGui::CollapsingHeader("Pose source", ImGuiTreeNodeFlags_DefaultOpen)){
+            bool synthetic = poseProvider.load() == &syntheticPoseProvider;
+            if(ImGui::Checkbox("Synthetic tracker", &synthetic)) {
+                selectPoseProvider(synthetic);
+            }
+            if(!synthetic) {
+                ImGui::Text("Rate");
+                ImGui::PushItemWidth(-1);
+                float rate = (float)syntheticPoseProvider.rateHz;
+                ImGui::SliderFloat("##syntheticrate", &rate, 60.0f, 2000.0f, "%.0f Hz");
+                syntheticPoseProvider.rateHz = rate;
+                ImGui::SliderFloat("##syntheticamplitude", &syntheticPoseProvider.amplitude, 0.0f, 2.0f, "Amplitude %.2f");
+                ImGui::PopItemWidth();
+            }
+            ImGui::Text("%llu samples", (unsigned long long)poseProvider.load()->History().Count());
+        }
+        if (ImGui::CollapsingHeader("Pose prediction", ImGuiTreeNodeFlags_DefaultOpen)){
+            int mode = (int)predictionMode.load();
+            ImGui::RadioButton("None", &mode, (int)PredictionMode::None);
+            ImGui::SameLine();
+            ImGui::RadioButton("Velocity", &mode, (int)PredictionMode::ConstantVelocity);
+            ImGui::SameLine();
+            ImGui::RadioButton("Accel.", &mode, (int)PredictionMode::ConstantAcceleration);
+            predictionMode = (PredictionMode)mode;
+            ImGui::Text("Smoothing");
+            ImGui::PushItemWidth(-1);
+            float smoothing = predictionSmoothing;
+            ImGui::SliderFloat("##predictsmoothing", &smoothing, 0.0f, 0.95f);
+            predictionSmoothing = smoothing;
+            ImGui::PopItemWidth();
+            ImGui::Text("Render predicted %.1f ms ahead", (float)(1000.0 * renderPhotonLatency));
+        }
+        if (ImGui::CollapsingHeader("Scheduling", ImGuiTreeNodeFlags_DefaultOpen)){
+            ImGui::Checkbox("Just-in-time warp (with vsync)", &useWarpScheduler);
+            ImGui::Text("Vsync safety margin (ms)");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderFloat("##vsyncmargin", &vsyncScheduler.safetyMarginMs, 0.0f, 8.0f);
+            ImGui::PopItemWidth();
+        }
+        if (ImGui::CollapsingHeader("Frame pacing", ImGuiTreeNodeFlags_DefaultOpen)){
+            int mode = (int)pacingMode;
+            ImGui::RadioButton("Spin", &mode, (int)PacingMode::Spin);
+            ImGui::SameLine();
+            ImGui::RadioButton("Display rate", &mode, (int)PacingMode::DisplayRate);
+            ImGui::SameLine();
+            ImGui::RadioButton("Skip unchanged", &mode, (int)PacingMode::SkipUnchanged);
+            pacingMode = (PacingMode)mode;
+            if(useVsync) {
+                ImGui::Text("Paced by vsync; the timer is off");
+            } else {
+                ImGui::Text("Timer at %.0f Hz", (float)framePacer.RateHz());
+            }
+        }
+        if (ImGui::CollapsingHeader("Beam racing")){
+            ImGui::Checkbox("Warp in slices, racing a virtual scanout", &useBeamRacing);
+            ImGui::Text("Slices");
+            ImGui::PushItemWidth(-1);
+            int slices = beamRacer.NumSlices();
+            if (ImGui::SliderInt("##slices", &slices, 1, BeamRacer::MAX_SLICES)) {
+                beamRacer.SetNumSlices(slices);
+            }
+            ImGui::Text("Slice safety margin (ms)");
+            ImGui::SliderFloat("##slicemargin", &beamRacer.safetyMarginMs, 0.0f, 4.0f);
+            ImGui::PopItemWidth();
+            ImGui::Text("Runs the %s warp for %s", beamRacedWarpName(warpAlgorithm), WarpAlgorithmName(warpAlgorithm));
+            ImGui::Text("Mono only; turn vsync off, so the swap doesn't hold it up");
+        }
+        if (ImGui::CollapsingHeader("Rotation-only fast path", ImGuiTreeNodeFlags_DefaultOpen)){
+            ImGui::Checkbox("Enable fast path", &useRotationFastPath);
+            ImGui::Text("Translation threshold");
+            ImGui::PushItemWidth(-1);
+            ImGui::SliderFloat("##1", &rotationOnlyThreshold, 0.0f, 0.01f, "%.4f");
+            ImGui::PopItemWidth();
+            if (ImGui::Button("Reset counters")) {
+                warpCount = 0;
+                rotationOnlyWarpCount = 0;
+            }
+        }
+
+        ImGui::End();
+    }
+
     // Stats overlay
     ImGuiWindowFlags overlay_flags = ImGuiWindowFlags_NoDecoration |
                                     ImGuiWindowFlags_AlwaysAutoResize |
@@ -276,29 +1099,100 @@ void OpenwarpApplication::drawGUI(){
     ImGui::Text("Is rendering? ");
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), shouldRenderScene ? "Yes" : "No");
+    ImGui::Text("Render waited on warp: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%llu times", (unsigned long long)renderStallCount);
+    ImGui::Text("Warped frame: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "#%llu, %.1f ms old",
+                        (unsigned long long)warpedFrameId, (float)(1000.0 * (glfwGetTime() - warpedFrameTime)));
+    ImGui::Text("Reused eye buffers: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.1f%%, avg. %.1f ms old",
+                        presentedFrameCount ? (float)(100.0 * reusedFrameCount / presentedFrameCount) : 0.0f,
+                        (float)presentedAgeMs);
+    ImGui::Text("Scene GPU time: ");
+    ImGui::SameLine();
+    if(useStereo && !stereoFromMono) {
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.2f ms", (float)sceneGpuMs);
+    } else {
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.2f ms (+ %.2f ms depth preparation)",
+                            (float)sceneGpuMs, (float)depthPrepGpuMs);
+    }
     ImGui::Text("Presentation framerate: ");
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.2f hz", (float)presentationFramerate);
     ImGui::Text("Current reprojection algo: ");
     ImGui::SameLine();
-    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), useRay ? "Raymarch-based" : "Mesh-based");
+    if(useBeamRacing && !useStereo && shouldReproject) {
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s (beam racing: %s warp)", WarpAlgorithmName(warpAlgorithm), beamRacedWarpName(warpAlgorithm));
+    } else {
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s%s", WarpAlgorithmName(warpAlgorithm), budgetFallbackActive ? " (budget fallback)" : "");
+    }
+    if(useGovernor) {
+        ImGui::Text("Governor level: ");
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%s", governor.Current().name);
+    }
     ImGui::Text("Is reprojecting? ");
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), shouldReproject ? "Yes" : "No");
     ImGui::Text("Mesh size: ");
     ImGui::SameLine();
-    if(useRay) {
+    if(warpAlgorithm != WarpAlgorithm::Mesh) {
         ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "N/A");
     } else {
-        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%d x %d", meshWidth, meshHeight);
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%zu x %zu", meshWidth, meshHeight);
     }
-    
-    if (useVsync == true)
-    {
-        ImGui::Button(" Vsync ON ");
-        if (ImGui::IsItemClicked(0))
-        {
-            useVsync = !useVsync;
+    ImGui::Text("Rotation-only warps: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.1f%% (%llu of %llu)",
+                        warpCount ? (float)(100.0 * rotationOnlyWarpCount / warpCount) : 0.0f,
+                        (unsigned long long)rotationOnlyWarpCount, (unsigned long long)warpCount);
+    ImGui::Text("Warp GPU time: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.3f ms", (float)warpTimer.averageMs);
+    ImGui::Text("Main thread busy: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.1f%% (%.1f%% spinning)",
+                        (float)(100.0 * framePacer.CpuUtilisation()), (float)(100.0 * framePacer.SpinCpuUtilisation()));
+    ImGui::Text("GPU busy warping: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.1f%% (%.1f%% spinning)",
+                        (float)(100.0 * framePacer.GpuUtilisation()), (float)(100.0 * framePacer.SpinGpuUtilisation()));
+    if(pacingMode == PacingMode::SkipUnchanged) {
+        ImGui::Text("Skipped warps: ");
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%llu of %llu",
+                            (unsigned long long)framePacer.Skipped(), (unsigned long long)framePacer.Frames());
+    }
+    if(useBeamRacing && !useStereo) {
+        ImGui::Text("Beam racing: ");
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.3f ms per slice, %.2f ms refresh",
+                            (float)beamRacer.SliceCostMs(), (float)(1000.0 * beamRacer.Period()));
+        for(int slice = 0; slice < beamRacer.NumSlices(); slice++) {
+            ImGui::Text("  Slice %d: ", slice);
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%.2f ms (%.2f ms one pose), %llu of %llu late",
+                                (float)beamRacer.LatencyMs(slice), (float)beamRacer.FramePoseLatencyMs(slice),
+                                (unsigned long long)beamRacer.Misses(slice), (unsigned long long)beamRacer.Frames());
+        }
+    }
+    if(useVsync && useWarpScheduler) {
+        ImGui::Text("Missed vsync deadlines: ");
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "%llu of %llu (%.2f ms period)",
+                            (unsigned long long)vsyncScheduler.Misses(), (unsigned long long)vsyncScheduler.Frames(),
+                            (float)(1000.0 * vsyncScheduler.Period()));
+    }
+    
+    if (useVsync == true)
+    {
+        ImGui::Button(" Vsync ON ");
+        if (ImGui::IsItemClicked(0))
+        {
+            useVsync = !useVsync;
             glfwSwapInterval(useVsync ? 1 : 0);
         }
     } else {
@@ -328,6 +1222,9 @@ void OpenwarpApplication::drawGUI(){
     ImGui::Text("Switch reprojection type: ");
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "T");
+    ImGui::Text("Change mesh resolution: ");
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "[ ]");
     ImGui::Text("Toggle reprojection: ");
     ImGui::SameLine();
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "R");
@@ -355,40 +1252,149 @@ void OpenwarpApplication::processInput(){
         // Query cursor position for rotation
         double xpos, ypos;
         glfwGetCursorPos(window, &xpos, &ypos);
+
         orientation = Eigen::AngleAxisf(((xpos - xpos_onfocus) + xpos_unfocus) / WIDTH, -Eigen::Vector3f::UnitY()) * Eigen::AngleAxisf(((ypos - ypos_onfocus) + ypos_unfocus) / HEIGHT, -Eigen::Vector3f::UnitX());
 
         // Alter position based on user orientation and input.
         position += (orientation * translation) * (glfwGetTime() - lastInputTime);
+    }
+    lastInputTime = glfwGetTime();
 
-        lastInputTime = glfwGetTime();
+    inputPoseProvider.Push(lastInputTime, position, orientation);
+}
+
+void OpenwarpApplication::selectPoseProvider(bool synthetic){
+    if(synthetic) {
+        syntheticPoseProvider.origin = position;
+        syntheticPoseProvider.baseOrientation = orientation;
+        syntheticPoseProvider.Start();
+        poseProvider = &syntheticPoseProvider;
+    } else {
+        poseProvider = &inputPoseProvider;
+        syntheticPoseProvider.Stop();
     }
 }
 
-void OpenwarpApplication::doReprojection(bool useRay){
+void OpenwarpApplication::doReprojection(WarpAlgorithm algorithm, uint64_t frameId){
 
-    if(useRay) {
-        glBindVertexArray(rayProgram.vao);
-        glUseProgram(rayProgram.program);
+    if(!acquireWarpSource(frameId)) {
+        return;
+    }
+
+    warpTimer.Begin();
+    warpCount++;
 
-        // Upload matrices of the rendered frame.
-        glUniformMatrix4fv(rayProgram.u_renderPV, 1, GL_FALSE, (GLfloat*)((projection * renderedCameraMatrix.inverse()).eval().data()));
+    // Calculate a fresh camera matrix, predicted for when the warp is displayed.
+    double photonTime = warpPhotonTime();
+    auto freshCameraMatrix = predictedCameraMatrix(warpPredictor, photonTime);
 
-        glUniform3fv(rayProgram.u_warpPos, 1, position.data());
-        // Calculate a fresh camera matrix.
-        auto freshCameraMatrix = createCameraMatrix(position, orientation);
+    // If the head has only rotated since the frame was rendered, a single
+    // homography is exact, and far cheaper than any of the full algorithms.
+    // The debug grid needs worldspace positions, so it disables the fast path.
+    Eigen::Vector3f renderedPosition = renderedCameraMatrix.block<3,1>(0,3);
+    Eigen::Vector3f freshPosition = freshCameraMatrix.block<3,1>(0,3);
+    // A mono frame while in stereo: both eyes are synthesized from it.
+    bool fromMono = useStereo && !warpingStereo;
 
-        // Compute VP matrix for fresh pose.
-        // auto freshVP = projection * freshCameraMatrix.inverse();
+    homographyMode = HomographyMode::None;
+    if(warpingStereo || fromMono) {
 
-        glUniformMatrix4fv(rayProgram.u_warpInverseVP, 1, GL_FALSE, (GLfloat*)((freshCameraMatrix * projection.inverse()).eval().data()));
+        // Stereo output always takes the stereo warps.
 
-        // Uploade parameter/config uniforms
-        glUniform1f(rayProgram.u_power, rayPower);
-        glUniform1f(rayProgram.u_stepSize, rayStepSize);
-        glUniform1f(rayProgram.u_depthOffset, rayDepthOffset);
-        glUniform1f(rayProgram.u_occlusionThreshold, occlusionThreshold);
-        glUniform1f(rayProgram.u_occlusionOffset, occlusionOffset);
+    } else if(useRotationFastPath && !showDebugGrid &&
+        (freshPosition - renderedPosition).norm() < rotationOnlyThreshold) {
+
+        rotationOnlyWarpCount++;
+        homographyMode = HomographyMode::Rotation;
+
+    } else if(algorithm == WarpAlgorithm::Planar) {
+
+        updatePlaneFit();
+        homographyMode = HomographyMode::Plane;
+    }
+
+    if(fromMono) {
+
+        // Each eye is a warp of its own, with its own pose slot,
+        // so there's no single pose left to late-latch.
+        doStereoFromMonoWarp(algorithm, freshCameraMatrix);
+        warpTimer.End();
 
+    } else {
+
+        latePose.Begin(WARP_POSE_BINDING);
+        latchPose(freshCameraMatrix, projection);
+
+        if(warpingStereo) {
+            doStereoWarp();
+        } else if(homographyMode != HomographyMode::None) {
+            doHomographyWarp();
+        } else if(algorithm == WarpAlgorithm::Splat) {
+            doSplatWarp();
+        } else if(algorithm == WarpAlgorithm::Hybrid) {
+            doHybridWarp(freshCameraMatrix);
+        } else if(algorithm == WarpAlgorithm::Ray && rayResolutionDivisor > 1) {
+            doRayReducedWarp(freshCameraMatrix);
+        } else if(algorithm == WarpAlgorithm::Ray && rayUseCompute) {
+            doRayComputeWarp(freshCameraMatrix);
+        } else {
+            doDepthWarp(algorithm == WarpAlgorithm::Ray, freshCameraMatrix);
+        }
+
+        warpTimer.End();
+
+        // Late latch. The warp has been issued but not flushed yet, so sample
+        // the pose provider once more (it may have a newer sample by now) and
+        // overwrite the pose the warp will read. Only the pose changes;
+        // anything decided on the CPU from the earlier pose (fast path, ray
+        // iteration budget) stands. Input is left to the main loop, which
+        // integrates it once per frame.
+        if(useLateLatch) {
+            latchPose(predictedCameraMatrix(warpPredictor, photonTime), projection);
+        }
+        latePose.End();
+    }
+
+    // Flushes the warp.
+    releaseWarpSource();
+
+    // Timings arrive a few warps late, and not every warp; count each once.
+    if(useGovernor) {
+        if(warpTimer.results != governorTimerResults) {
+            governorTimerResults = warpTimer.results;
+            governor.budgetMs = warpBudgetMs;
+            if(governor.Update(glfwGetTime(), warpTimer.lastMs)) {
+                applyQualityLevel(governor.Current());
+            }
+        }
+        return;
+    }
+
+    // Emergency fallback. If the warp keeps blowing the GPU budget,
+    // drop to the cheapest algorithm we have.
+    if(useBudgetFallback && algorithm != WarpAlgorithm::Planar &&
+        warpTimer.averageMs > warpBudgetMs) {
+
+        std::cout << "Warp took " << warpTimer.averageMs << " ms (budget " << warpBudgetMs
+                  << " ms); falling back to planar reprojection." << std::endl;
+        warpAlgorithm = WarpAlgorithm::Planar;
+        budgetFallbackActive = true;
+    }
+}
+
+void OpenwarpApplication::doDepthWarp(bool useRay, const Eigen::Matrix4f& freshCameraMatrix, GLuint framebuffer, GLsizei width){
+
+    if(useRay) {
+        glBindVertexArray(rayProgram.vao);
+        glUseProgram(rayProgram.program);
+
+        setRayUniforms(rayProgram, freshCameraMatrix);
+
+        // Hits are remembered per output pixel, which means nothing
+        // when consecutive warps are of different eyes.
+        if(useStereo) {
+            glUniform1i(rayProgram.u_useHistory, GL_FALSE);
+        }
     } else {
         glBindVertexArray(meshProgram.vao);
         glUseProgram(meshProgram.program);
@@ -396,25 +1402,19 @@ void OpenwarpApplication::doReprojection(bool useRay){
         // Upload inverse view matrix (camera matrix) of the rendered frame.
         glUniformMatrix4fv(meshProgram.u_renderInverseV, 1, GL_FALSE, (GLfloat*)(renderedCameraMatrix.data()));
 
-        // Calculate a fresh camera matrix.
-        auto freshCameraMatrix = createCameraMatrix(position, orientation);
-
-        // Compute VP matrix for fresh pose.
-        auto freshVP = projection * freshCameraMatrix.inverse();
-
-        // Upload the fresh VP matrix.
-        glUniformMatrix4fv(meshProgram.u_warp_vp, 1, GL_FALSE, (GLfloat*)freshVP.eval().data());
+        glUniform1f(meshProgram.u_near, projectionNear());
+        glUniform1f(meshProgram.u_far, projectionFar());
 
         glUniform1f(meshProgram.u_bleedRadius, bleedRadius);
         glUniform1f(meshProgram.u_bleedTolerance, bleedTolerance);
         glUniform1f(meshProgram.u_debugOpacity, showDebugGrid ? 1.0f : 0.0f);
     }
 
-    // Render directly to screen. If we were going to send this to a
-    // lens undistort shader, we'd create another FBO and render to that.
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Render directly to screen, unless asked otherwise. If we were going to
+    // send this to a lens undistort shader, we'd create another FBO and render to that.
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
-    glViewport(0,0,WIDTH,HEIGHT);
+    glViewport(0,0,width ? width : WIDTH,HEIGHT);
     glDisable(GL_CULL_FACE);
     glDepthFunc(GL_LEQUAL);
     glEnable(GL_DEPTH_TEST);
@@ -430,25 +1430,577 @@ void OpenwarpApplication::doReprojection(bool useRay){
 
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, renderTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, hizTexture);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, linearDepthTexture);
+
+    if(useRay) {
+        glBindImageTexture(1, rayHistoryTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, useRay ? rayProgram.mesh_indices_vbo : meshProgram.mesh_indices_vbo);
+    glDrawElements(GL_TRIANGLES, useRay ? rayProgram.mesh_indices.size() : meshProgram.num_indices, GL_UNSIGNED_INT, NULL);
+
+    if(useRay) {
+        // The next warp reads back this warp's hits.
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+}
+
+void OpenwarpApplication::setRayUniforms(const owRayProgram& ray, const Eigen::Matrix4f& freshCameraMatrix){
+    // Upload matrices of the rendered frame.
+    glUniformMatrix4fv(ray.u_renderPV, 1, GL_FALSE, (GLfloat*)((projection * renderedCameraMatrix.inverse()).eval().data()));
+
+    glUniform1f(ray.u_near, projectionNear());
+
+    // Uploade parameter/config uniforms
+    glUniform1f(ray.u_power, rayPower);
+    glUniform1f(ray.u_stepSize, rayStepSize);
+    glUniform1f(ray.u_depthOffset, rayDepthOffset);
+    glUniform1f(ray.u_occlusionThreshold, occlusionThreshold);
+    glUniform1f(ray.u_occlusionOffset, occlusionOffset);
+
+    glUniform1i(ray.u_maxIterations, rayMaxIterations);
+    glUniform1f(ray.u_convergenceThreshold, rayConvergenceThreshold);
+    glUniform1i(ray.u_deferredColor, rayDeferredColor);
+    glUniform1i(ray.u_debugIterations, rayDebugIterations);
+
+    glUniform1i(ray.u_useHiZ, rayUseHiZ);
+    glUniform1i(ray.u_hizMaxLevel, hizLevels - 1);
+    glUniform1i(ray.u_hizRefineIterations, rayHiZRefineIterations);
+
+    glUniform1i(ray.u_useHistory, rayUseHistory);
+    glUniform1i(ray.u_historyIterations, rayHistoryIterations);
+    glUniform1f(ray.u_historyTolerance, rayHistoryTolerance);
+
+    // Parallax, in output pixels, of a point at unit depth.
+    Eigen::Vector3f renderedPosition = renderedCameraMatrix.block<3,1>(0,3);
+    Eigen::Vector3f freshPosition = freshCameraMatrix.block<3,1>(0,3);
+    float parallaxScale = projection(0,0) * (WIDTH / 2.0f) * (freshPosition - renderedPosition).norm();
+
+    glUniform1i(ray.u_adaptiveIterations, rayAdaptiveIterations);
+    glUniform1f(ray.u_parallaxScale, parallaxScale);
+    glUniform1f(ray.u_iterationsPerPixel, rayIterationsPerPixel);
+    glUniform1i(ray.u_minIterations, rayMinIterations);
+
+    glUniform1i(ray.u_useTileList, GL_FALSE);
+    glUniform1i(ray.u_showTiles, GL_FALSE);
+    glUniform1i(ray.u_adaptivePerTile, rayAdaptivePerTile);
+}
+
+void OpenwarpApplication::doRayComputeWarp(const Eigen::Matrix4f& freshCameraMatrix, bool useTileList){
+    glUseProgram(rayComputeProgram.program);
+    setRayUniforms(rayComputeProgram, freshCameraMatrix);
+    glUniform1i(rayComputeProgram.u_useTileList, useTileList);
+    glUniform1i(rayComputeProgram.u_showTiles, useTileList && hybridShowTiles);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, hizTexture);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, linearDepthTexture);
+
+    glBindImageTexture(0, rayOutputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    glBindImageTexture(1, rayHistoryTexture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA32F);
+
+    // One workgroup per 16x16 output tile.
+    if(useTileList) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, hybridProgram.tile_buffer);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, hybridProgram.tile_buffer);
+        glDispatchComputeIndirect(0);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    } else {
+        glDispatchCompute((WIDTH + 15) / 16, (HEIGHT + 15) / 16, 1);
+    }
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    // Present.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, rayOutputFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OpenwarpApplication::doHybridWarp(const Eigen::Matrix4f& freshCameraMatrix){
+
+    // Mesh warp everywhere, into the compute raymarch's color target.
+    doDepthWarp(false, freshCameraMatrix, rayOutputFBO);
+
+    // The raymarch imageStores over what was just rasterized.
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+
+    // Classify tiles. The tile count is the indirect dispatch's x size.
+    const GLuint emptyDispatch[3] = { 0, 1, 1 };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, hybridProgram.tile_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(emptyDispatch), emptyDispatch);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, hybridProgram.tile_buffer);
+
+    glUseProgram(hybridProgram.classify.program);
+    setRayUniforms(hybridProgram.classify, freshCameraMatrix);
+    glUniform2i(hybridProgram.u_outputSize, WIDTH, HEIGHT);
+    glUniform1f(hybridProgram.u_discontinuityThreshold, hybridDiscontinuityThreshold);
+
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, hizTexture);
+
+    GLuint tilesX = (WIDTH + 15) / 16;
+    GLuint tilesY = (HEIGHT + 15) / 16;
+    glDispatchCompute((tilesX + 7) / 8, (tilesY + 7) / 8, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // Raymarch just the marked tiles, over the mesh warp, and present.
+    doRayComputeWarp(freshCameraMatrix, true);
+}
+
+void OpenwarpApplication::doRayReducedWarp(const Eigen::Matrix4f& freshCameraMatrix){
+    GLint marchWidth = WIDTH / rayResolutionDivisor;
+    GLint marchHeight = HEIGHT / rayResolutionDivisor;
+
+    glUseProgram(rayReducedProgram.march.program);
+    setRayUniforms(rayReducedProgram.march, freshCameraMatrix);
+    glUniform2i(rayReducedProgram.u_marchSize, marchWidth, marchHeight);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, hizTexture);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, linearDepthTexture);
+
+    glBindImageTexture(0, rayReducedProgram.hit_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+
+    glDispatchCompute((marchWidth + 15) / 16, (marchHeight + 15) / 16, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    // Resolve full-resolution color from the eye buffer.
+    glBindVertexArray(rayReducedProgram.vao);
+    glUseProgram(rayReducedProgram.upsample_program);
+    glUniform2i(rayReducedProgram.u_lowResSize, marchWidth, marchHeight);
+    glUniform1f(rayReducedProgram.u_depthSigma, rayUpsampleDepthSigma);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0,0,WIDTH,HEIGHT);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_2D, rayReducedProgram.hit_texture);
+
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void OpenwarpApplication::doSplatWarp(){
+
+    // Nothing has been splatted yet.
+    const GLuint empty = 0xFFFFFFFF;
+    glClearTexImage(splatProgram.depth_image, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &empty);
+
+    glUseProgram(splatProgram.program);
+
+    glUniformMatrix4fv(splatProgram.u_renderInverseP, 1, GL_FALSE, (GLfloat*)(projection.inverse().eval().data()));
+    glUniformMatrix4fv(splatProgram.u_renderInverseV, 1, GL_FALSE, (GLfloat*)(renderedCameraMatrix.data()));
+    glUniform1i(splatProgram.u_splatSize, splatSize);
+
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glBindImageTexture(0, splatProgram.depth_image, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+    glBindImageTexture(1, splatProgram.uv_image, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RG32F);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, useRay ? rayProgram.mesh_indices_vbo : meshProgram.mesh_indices_vbo);
-    glDrawElements(GL_TRIANGLES, useRay ? rayProgram.mesh_indices.size() : meshProgram.mesh_indices.size(), GL_UNSIGNED_INT, NULL);
+    // One invocation per eye buffer texel, 16x16 per work group.
+    GLuint groupsX = (WIDTH + 15) / 16;
+    GLuint groupsY = (HEIGHT + 15) / 16;
 
-    
+    // Depth pass, then UV pass.
+    glUniform1i(splatProgram.u_pass, 0);
+    glDispatchCompute(groupsX, groupsY, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    glUniform1i(splatProgram.u_pass, 1);
+    glDispatchCompute(groupsX, groupsY, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    // Resolve color and fill holes, directly to screen.
+    glBindVertexArray(splatProgram.vao);
+    glUseProgram(splatProgram.resolve_program);
+    glUniform1i(splatProgram.u_holeFillRadius, splatHoleFillRadius);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0,0,WIDTH,HEIGHT);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderTexture);
+
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void OpenwarpApplication::createLinearDepthTexture(owEyeBuffer& eye){
+    if(eye.linear_depth_texture) {
+        glDeleteTextures(1, &eye.linear_depth_texture);
+    }
+
+    // Immutable storage, so the texture is recreated on format changes.
+    glGenTextures(1, &eye.linear_depth_texture);
+    glBindTexture(GL_TEXTURE_2D, eye.linear_depth_texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, linearDepthHalfFloat ? GL_R16F : GL_R32F, WIDTH, HEIGHT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, eye.linear_depth_fbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, eye.linear_depth_texture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OpenwarpApplication::linearizeDepth(owEyeBuffer& eye){
+    glBindVertexArray(linearizeProgram.vao);
+    glUseProgram(linearizeProgram.program);
+
+    glUniform1f(linearizeProgram.u_near, projectionNear());
+    glUniform1f(linearizeProgram.u_far, projectionFar());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, eye.linear_depth_fbo);
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, eye.depth_texture);
+
+    // Full-screen triangle; one fragment per eye buffer texel.
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OpenwarpApplication::buildHiZ(owEyeBuffer& eye){
+    glUseProgram(hizProgram);
+
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, eye.linear_depth_texture);
+
+    // Each level reduces 2x2 texels of the level below it.
+    for(GLint level = 0; level < hizLevels; level++) {
+        GLuint levelWidth = std::max(1u, WIDTH >> level);
+        GLuint levelHeight = std::max(1u, HEIGHT >> level);
+
+        if(level > 0) {
+            glBindImageTexture(0, eye.hiz_texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_RG32F);
+        }
+        glBindImageTexture(1, eye.hiz_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+        glUniform1i(hizLevelAttr, level);
+
+        glDispatchCompute((levelWidth + 15) / 16, (levelHeight + 15) / 16, 1);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+
+    // The warp samples the pyramid with texelFetch.
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void OpenwarpApplication::requestPlaneFit(owEyeBuffer& eye){
+
+    // Downsample the rendered depth. Depth blits have to be GL_NEAREST.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, eye.fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, planeFit.fbo);
+    glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, PLANE_FIT_SIZE, PLANE_FIT_SIZE, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    // Read back into the PBO; this returns immediately.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, planeFit.fbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, eye.plane_fit_pbo);
+    glReadPixels(0, 0, PLANE_FIT_SIZE, PLANE_FIT_SIZE, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(eye.plane_fit_fence) {
+        glDeleteSync(eye.plane_fit_fence);
+    }
+    eye.plane_fit_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void OpenwarpApplication::updatePlaneFit(){
+    // Fits the eye buffer being warped. Each one is only fitted once;
+    // after that, the fence is gone and we keep the plane we have.
+    owEyeBuffer& eye = eyeBuffers[warpingEyeBuffer];
+    if(!eye.plane_fit_fence) {
+        return;
+    }
+
+    // Don't wait; if the readback isn't done, keep using the previous plane.
+    GLenum status = glClientWaitSync(eye.plane_fit_fence, 0, 0);
+    if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return;
+    }
+    glDeleteSync(eye.plane_fit_fence);
+    eye.plane_fit_fence = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, eye.plane_fit_pbo);
+    const GLfloat* depth = (const GLfloat*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                        PLANE_FIT_SIZE * PLANE_FIT_SIZE * sizeof(GLfloat), GL_MAP_READ_BIT);
+    if(!depth) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return;
+    }
+
+    // Unproject every sample that hit geometry into the rendered view space.
+    Eigen::Matrix4f inverseProjection = projection.inverse();
+    std::vector<Eigen::Vector3f> points;
+    points.reserve(PLANE_FIT_SIZE * PLANE_FIT_SIZE);
+    for(GLuint y = 0; y < PLANE_FIT_SIZE; y++) {
+        for(GLuint x = 0; x < PLANE_FIT_SIZE; x++) {
+            float z = depth[y * PLANE_FIT_SIZE + x];
+            if(z >= 1.0f) {
+                continue; // Background
+            }
+            Eigen::Vector4f ndc((x + 0.5f) / PLANE_FIT_SIZE * 2.0f - 1.0f,
+                                (y + 0.5f) / PLANE_FIT_SIZE * 2.0f - 1.0f,
+                                z * 2.0f - 1.0f,
+                                1.0f);
+            Eigen::Vector4f view = inverseProjection * ndc;
+            points.push_back(view.head<3>() / view.w());
+        }
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if(points.size() < 3) {
+        planeFit.valid = false;
+        return;
+    }
+
+    // Least-squares plane: through the centroid, with the normal
+    // along the direction of least variance.
+    Eigen::Vector3f centroid = Eigen::Vector3f::Zero();
+    for(auto& p : points) {
+        centroid += p;
+    }
+    centroid /= points.size();
+
+    Eigen::Matrix3f covariance = Eigen::Matrix3f::Zero();
+    for(auto& p : points) {
+        covariance += (p - centroid) * (p - centroid).transpose();
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> solver(covariance);
+    Eigen::Vector3f normal = solver.eigenvectors().col(0);
+
+    // Orient the normal away from the camera.
+    float distance = normal.dot(centroid);
+    if(distance < 0) {
+        normal = -normal;
+        distance = -distance;
+    }
+
+    // A plane seen edge-on (or through the eye) is useless for reprojection.
+    planeFit.valid = distance > 1e-3f;
+    planeFit.normal = normal;
+    planeFit.distance = distance;
 }
 
-void OpenwarpApplication::renderScene(){
-    // Render to FBO.
+void OpenwarpApplication::latchPose(const Eigen::Matrix4f& freshCameraMatrix, const Eigen::Matrix4f& warpProjection){
+    WarpPose pose = {};
+
+    Eigen::Matrix4f warpVP = warpProjection * freshCameraMatrix.inverse();
+    Eigen::Matrix4f warpInverseVP = freshCameraMatrix * warpProjection.inverse();
+    std::memcpy(pose.warpVP, warpVP.data(), sizeof(pose.warpVP));
+    std::memcpy(pose.warpInverseVP, warpInverseVP.data(), sizeof(pose.warpInverseVP));
+    std::memcpy(pose.warpPos, freshCameraMatrix.block<3,1>(0,3).eval().data(), 3 * sizeof(GLfloat));
+
+    Eigen::Matrix3f homography = Eigen::Matrix3f::Identity();
+    if(homographyMode == HomographyMode::Rotation) {
+        homography = rotationHomography(freshCameraMatrix);
+    } else if(homographyMode == HomographyMode::Plane) {
+        if(planarUseFittedPlane && planeFit.valid) {
+            homography = planeHomography(freshCameraMatrix, planeFit.normal, planeFit.distance);
+        } else {
+            homography = planeHomography(freshCameraMatrix, Eigen::Vector3f(0,0,-1), planarFocalDistance);
+        }
+    }
+
+    // std140 pads each mat3 column out to a vec4.
+    for(int column = 0; column < 3; column++) {
+        std::memcpy(pose.homography + 4 * column, homography.col(column).data(), 3 * sizeof(GLfloat));
+    }
+
+    float eyeIpd = ipd;
+    for(int e = 0; e < NUM_EYES; e++) {
+        Eigen::Matrix4f eyeWarpVP = eyeProjection[e] * eyeCameraMatrix(freshCameraMatrix, e, eyeIpd).inverse();
+        std::memcpy(pose.eyeWarpVP[e], eyeWarpVP.data(), sizeof(pose.eyeWarpVP[e]));
+    }
+
+    latePose.Latch(pose);
+}
+
+void OpenwarpApplication::doHomographyWarp(){
+    glBindVertexArray(homographyProgram.vao);
+    glUseProgram(homographyProgram.program);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glViewport(0,0,WIDTH,HEIGHT);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderTexture);
+
+    // Full-screen triangle; positions are generated in the vertex shader.
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void OpenwarpApplication::doBeamRacedWarp(WarpAlgorithm algorithm){
+
+    if(!acquireWarpSource()) {
+        return;
+    }
+    warpCount++;
+
+    bool useRay = algorithm == WarpAlgorithm::Ray;
+    int numSlices = beamRacer.NumSlices();
+    beamRacer.BeginFrame(glfwGetTime());
+
+    glEnable(GL_SCISSOR_TEST);
+    for(int slice = 0; slice < numSlices; slice++) {
+
+        // Wait until scanout is about to reach the slice, then take the
+        // freshest pose from the provider, predicted for when its middle row
+        // is scanned out. Input is left to the main loop, once per frame.
+        PreciseSleepUntil(beamRacer.WarpStart(slice));
+        PoseSample sample;
+        poseProvider.load()->History().Latest(sample);
+        Eigen::Matrix4f sliceCameraMatrix = predictedCameraMatrix(warpPredictor, beamRacer.ScanoutMiddle(slice));
+        double issueTime = glfwGetTime();
+
+        // Slice 0 is the top of the screen.
+        GLint top = HEIGHT - slice * HEIGHT / numSlices;
+        GLint bottom = HEIGHT - (slice + 1) * HEIGHT / numSlices;
+        glScissor(0, bottom, WIDTH, top - bottom);
+
+        // The warp mesh needn't cover every texel; don't leave the last frame's there.
+        glBindFramebuffer(GL_FRAMEBUFFER, frontBufferFBO);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        latePose.Begin(WARP_POSE_BINDING);
+        latchPose(sliceCameraMatrix, projection);
+        doDepthWarp(useRay, sliceCameraMatrix, frontBufferFBO);
+
+        // Late latch, as for whole frames.
+        if(useLateLatch) {
+            poseProvider.load()->History().Latest(sample);
+            latchPose(predictedCameraMatrix(warpPredictor, beamRacer.ScanoutMiddle(slice)), projection);
+        }
+        latePose.End();
+
+        // Beam racing has to know each slice made it before moving on;
+        // the wait also times it.
+        GLsync sliceFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glClientWaitSync(sliceFence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(sliceFence);
+        beamRacer.SliceDone(slice, sample.time, issueTime, glfwGetTime());
+    }
+    glDisable(GL_SCISSOR_TEST);
+
+    releaseWarpSource();
+
+    // There's no real front buffer to race, so show the finished frame.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, frontBufferFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, WIDTH, HEIGHT, 0, 0, WIDTH, HEIGHT, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OpenwarpApplication::doStereoFromMonoWarp(WarpAlgorithm algorithm, const Eigen::Matrix4f& freshCameraMatrix){
+    // The mono frame was rendered from the centre of the head; each eye
+    // is a warp of it across half the IPD (plus any head motion since).
+    // The raymarch fills in what that disoccludes; anything else uses
+    // the mesh warp, which stretches over it.
+    bool useRay = algorithm == WarpAlgorithm::Ray;
+    float eyeIpd = ipd;
+    for(int e = 0; e < NUM_EYES; e++) {
+        Eigen::Matrix4f eyeCamera = eyeCameraMatrix(freshCameraMatrix, e, eyeIpd);
+        latePose.Begin(WARP_POSE_BINDING);
+        latchPose(eyeCamera, eyeProjection[e]);
+        doDepthWarp(useRay, eyeCamera, stereoProgram.eye_fbo[e], EYE_WIDTH);
+        latePose.End();
+    }
+
+    presentStereo(stereoProgram.output_color);
+}
+
+void OpenwarpApplication::doStereoWarp(){
+    glBindVertexArray(stereoProgram.vao);
+    glUseProgram(stereoProgram.program);
+
+    GLfloat inverseP[NUM_EYES][16];
+    GLfloat inverseV[NUM_EYES][16];
+    for(int e = 0; e < NUM_EYES; e++) {
+        std::memcpy(inverseP[e], eyeProjection[e].inverse().eval().data(), sizeof(inverseP[e]));
+        std::memcpy(inverseV[e], renderedEyeCameraMatrix[e].data(), sizeof(inverseV[e]));
+    }
+    glUniformMatrix4fv(stereoProgram.u_renderInverseP, NUM_EYES, GL_FALSE, &inverseP[0][0]);
+    glUniformMatrix4fv(stereoProgram.u_renderInverseV, NUM_EYES, GL_FALSE, &inverseV[0][0]);
+
+    glUniform1f(stereoProgram.u_bleedRadius, bleedRadius);
+    glUniform1f(stereoProgram.u_bleedTolerance, bleedTolerance);
+    glUniform1f(stereoProgram.u_debugOpacity, showDebugGrid ? 1.0f : 0.0f);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, stereoProgram.fbo);
+
+    glViewport(0, 0, EYE_WIDTH, HEIGHT);
+    glDisable(GL_CULL_FACE);
+    glDepthFunc(GL_LEQUAL);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+
+    glBindBuffer(GL_ARRAY_BUFFER, stereoProgram.mesh_vertices_vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(vertex_t), (void*)offsetof(vertex_t, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vertex_t), (void*)offsetof(vertex_t, uv));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stereoProgram.mesh_indices_vbo);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, stereoColorArray);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, stereoDepthArray);
+
+    switch(stereoProgram.path) {
+        case StereoPath::Multiview:
+            // Clears, and draws into, every view at once.
+            glClear(GL_DEPTH_BUFFER_BIT);
+            glDrawElements(GL_TRIANGLES, stereoProgram.num_indices, GL_UNSIGNED_INT, NULL);
+            break;
+        case StereoPath::Layered:
+            glClear(GL_DEPTH_BUFFER_BIT);
+            glDrawElementsInstanced(GL_TRIANGLES, stereoProgram.num_indices, GL_UNSIGNED_INT, NULL, NUM_EYES);
+            break;
+        case StereoPath::PerEye:
+            for(int e = 0; e < NUM_EYES; e++) {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, stereoProgram.output_color, 0, e);
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, stereoProgram.output_depth, 0, e);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                glUniform1i(stereoProgram.u_eye, e);
+                glDrawElements(GL_TRIANGLES, stereoProgram.num_indices, GL_UNSIGNED_INT, NULL);
+            }
+            break;
+    }
+
+    presentStereo(stereoProgram.output_color);
+}
+
+void OpenwarpApplication::renderScene(owEyeBuffer& eye){
+    // Render to the eye buffer. Without reprojection, it's blitted straight to the screen.
     glBindVertexArray(demoVAO);
     glUseProgram(demoShaderProgram);
 
-    // If reprojection is disabled, we render straight to the screen.
-    if (shouldReproject)
-        glBindFramebuffer(GL_FRAMEBUFFER, renderFBO);
-    else
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, eye.fbo);
     
     glViewport(0, 0, WIDTH, HEIGHT);
     glEnable(GL_CULL_FACE);
@@ -459,23 +2011,89 @@ void OpenwarpApplication::renderScene(){
     glClearDepth(1);
 
     // Set up user view matrix.
-    // We save the camera matrix, so that when Openwarp runs, it can use both
+    // The camera matrix is kept with the eye buffer, so that when Openwarp runs, it can use both
     // the rendered camera matrix, as well as the updated "fresh" camera matrix.
-    renderedCameraMatrix = createCameraMatrix(position, orientation);
-    renderedView = renderedCameraMatrix.inverse();
+    renderedView = eye.camera_matrix.inverse();
 
     glUniformMatrix4fv(demoModelViewAttr, 1, GL_FALSE, (GLfloat*)(renderedView.data()));
     glUniformMatrix4fv(demoProjectionAttr, 1, GL_FALSE, (GLfloat*)(projection.data()));    
 
     glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    sceneTimer.Begin();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     demoscene.Draw();
-    glFlush();
+    sceneTimer.End();
+
+    // Always prepared, since reprojection can be switched on at any time.
+    depthPrepTimer.Begin();
+    linearizeDepth(eye);
+    requestPlaneFit(eye);
+    buildHiZ(eye);
+    depthPrepTimer.End();
+}
+
+void OpenwarpApplication::renderStereoScene(owEyeBuffer& eye){
+    // Both eyes, one after the other, into the layers of the stereo arrays.
+    // Only the mesh warp handles stereo, so none of the depth
+    // preparation the mono warps need is done.
+    glBindVertexArray(demoVAO);
+    glUseProgram(demoShaderProgram);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, eye.stereo_fbo);
+
+    glViewport(0, 0, EYE_WIDTH, HEIGHT);
+    glEnable(GL_CULL_FACE);
+    glDepthFunc(GL_LEQUAL);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glClearDepth(1);
+    glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
+
+    float eyeIpd = ipd;
+    sceneTimer.Begin();
+    for(int e = 0; e < NUM_EYES; e++) {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, eye.stereo_color_array, 0, e);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, eye.stereo_depth_array, 0, e);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        eye.eye_camera_matrix[e] = eyeCameraMatrix(eye.camera_matrix, e, eyeIpd);
+        Eigen::Matrix4f view = eye.eye_camera_matrix[e].inverse();
+        glUniformMatrix4fv(demoModelViewAttr, 1, GL_FALSE, (GLfloat*)(view.data()));
+        glUniformMatrix4fv(demoProjectionAttr, 1, GL_FALSE, (GLfloat*)(eyeProjection[e].data()));
+
+        demoscene.Draw();
+    }
+    sceneTimer.End();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OpenwarpApplication::burnGpuTime(double ms){
+    // Chunk cost is only known once one has been timed; guess until then.
+    double chunkMs = stallProgram.timer.averageMs > 0.0 ? stallProgram.timer.averageMs : 0.5;
+    int chunks = std::clamp((int)std::lround(ms / chunkMs), 1, MAX_STALL_CHUNKS);
+
+    glUseProgram(stallProgram.program);
+    glUniform1i(stallProgram.u_iterations, STALL_CHUNK_ITERATIONS);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, stallProgram.sink);
+
+    stallProgram.timer.Begin();
+    glDispatchCompute(STALL_CHUNK_GROUPS, 1, 1);
+    stallProgram.timer.End();
+    for(int i = 1; i < chunks; i++) {
+        glDispatchCompute(STALL_CHUNK_GROUPS, 1, 1);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glUseProgram(0);
 }
 
 OpenwarpApplication::~OpenwarpApplication(){
+    joinRenderThread();
+    syntheticPoseProvider.Stop();
     cleanupGL();
+    glfwDestroyWindow(renderContext);
     glfwDestroyWindow(window);
     glfwTerminate();
 }
@@ -487,17 +2105,49 @@ int OpenwarpApplication::initGL(){
     glEnable              ( GL_DEBUG_OUTPUT );
     glDebugMessageCallback( MessageCallback, 0 );
 
-    // Create both color and depth render textures
-    createRenderTexture(&renderTexture, WIDTH, HEIGHT, false);
-    createRenderTexture(&depthTexture, WIDTH, HEIGHT, true);
+    warpTimer.Init();
+    latePose.Init();
+
+    // Min/max depth pyramid, down to 1x1.
+    hizLevels = 1 + (GLint)std::floor(std::log2((double)std::max(WIDTH, HEIGHT)));
+
+    // Blits eye buffers to the screen when reprojection is off.
+    glGenFramebuffers(1, &presentFBO);
+
+    glGenTextures(1, &lastWarpTexture);
+    glBindTexture(GL_TEXTURE_2D, lastWarpTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, WIDTH, HEIGHT);
+    glGenFramebuffers(1, &lastWarpFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, lastWarpFBO);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, lastWarpTexture, 0);
+
+    // Beam racing warps into this, slice by slice; the warps need depth.
+    glGenTextures(1, &frontBufferTexture);
+    glBindTexture(GL_TEXTURE_2D, frontBufferTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, WIDTH, HEIGHT);
+    glGenTextures(1, &frontBufferDepth);
+    glBindTexture(GL_TEXTURE_2D, frontBufferDepth);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, WIDTH, HEIGHT);
+    glGenFramebuffers(1, &frontBufferFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, frontBufferFBO);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, frontBufferTexture, 0);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, frontBufferDepth, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    hizProgram = init_and_link_compute("../resources/shaders/openwarp_hiz.comp");
+    hizLevelAttr = glGetUniformLocation(hizProgram, "u_level");
 
-    // Create FBO that will render to them!
-    createFBO(&renderTexture, &renderFBO, &depthTexture, &renderDepthTarget, WIDTH, HEIGHT);
+    linearizeProgram.program = init_and_link("../resources/shaders/openwarp_fullscreen.vert", "../resources/shaders/openwarp_linearize.frag");
+    linearizeProgram.u_near = glGetUniformLocation(linearizeProgram.program, "u_near");
+    linearizeProgram.u_far = glGetUniformLocation(linearizeProgram.program, "u_far");
 
     // Load the .obj-file-based that will be rendered for the demo scene.
     demoscene = ObjScene(std::string(OBJ_DIR), "scene.obj");
 
     projection = perspective(45.0, (double)(WIDTH)/(double)(HEIGHT), 0.1, 100.0);
+    for(int e = 0; e < NUM_EYES; e++) {
+        eyeProjection[e] = eyePerspective(e, 45.0, (double)(EYE_WIDTH)/(double)(HEIGHT), 0.1, 100.0, stereoAsymmetry);
+    }
 
     // DEMO rendering initialization
     ////////////////////////////////
@@ -510,32 +2160,29 @@ int OpenwarpApplication::initGL(){
     demoModelViewAttr = glGetUniformLocation(demoShaderProgram, "u_modelview");
     demoProjectionAttr = glGetUniformLocation(demoShaderProgram, "u_projection");
 
-    // Create and bind global VAO object
-    glGenVertexArrays(1, &demoVAO);
-    glBindVertexArray(demoVAO);
-
     // Openwarp-mesh rendering initialization
     ////////////////////////////////
 
     glGenVertexArrays(1, &meshProgram.vao);
     glBindVertexArray(meshProgram.vao);
 
-    // Build the reprojection mesh for mesh-based Openwarp
-	BuildMesh(meshWidth, meshHeight, meshProgram.mesh_indices, meshProgram.mesh_vertices);
 
     // Build and link shaders for openwarp-mesh.
 	meshProgram.program = init_and_link("../resources/shaders/openwarp_mesh.vert", "../resources/shaders/openwarp_mesh.frag");
 
     // Get the color + depth samplers
     meshProgram.eye_sampler = glGetUniformLocation(meshProgram.program, "Texture");
-    meshProgram.depth_sampler = glGetUniformLocation(meshProgram.program, "_Depth");
+    meshProgram.depth_sampler = glGetUniformLocation(meshProgram.program, "_LinearDepth");
 
     // Get the warp matrix uniforms
     // Inverse V and P matrices of the rendered pose
     meshProgram.u_renderInverseP = glGetUniformLocation(meshProgram.program, "u_renderInverseP");
     meshProgram.u_renderInverseV = glGetUniformLocation(meshProgram.program, "u_renderInverseV");
-    // VP matrix of the fresh pose
-    meshProgram.u_warp_vp = glGetUniformLocation(meshProgram.program, "u_warpVP");
+    // The VP matrix of the fresh pose comes from the WarpPose block.
+
+    // Clip planes, for linear depth
+    meshProgram.u_near = glGetUniformLocation(meshProgram.program, "u_near");
+    meshProgram.u_far = glGetUniformLocation(meshProgram.program, "u_far");
 
     // Mesh edge bleed parameters
     meshProgram.u_bleedRadius = glGetUniformLocation(meshProgram.program, "bleedRadius");
@@ -544,16 +2191,61 @@ int OpenwarpApplication::initGL(){
     // Mesh edge bleed parameters
     meshProgram.u_debugOpacity = glGetUniformLocation(meshProgram.program, "u_debugOpacity");
 
-    // Generate, bind, and fill mesh VBOs.
-    glGenBuffers(1, &meshProgram.mesh_vertices_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, meshProgram.mesh_vertices_vbo);
-    glBufferData(GL_ARRAY_BUFFER, meshProgram.mesh_vertices.size() * sizeof(vertex_t), &meshProgram.mesh_vertices.at(0), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // Stereo openwarp-mesh. Prefer multiview, then instanced layered
+    // rendering; both warp the two eyes in a single draw.
+    std::string stereoDefines;
+    if(GLEW_OVR_multiview2) {
+        stereoProgram.path = StereoPath::Multiview;
+        stereoDefines = "#define OPENWARP_MULTIVIEW\n";
+    } else if(GLEW_ARB_shader_viewport_layer_array) {
+        stereoProgram.path = StereoPath::Layered;
+        stereoDefines = "#define OPENWARP_LAYERED\n";
+    } else {
+        stereoProgram.path = StereoPath::PerEye;
+    }
+    glGenVertexArrays(1, &stereoProgram.vao);
+    stereoProgram.program = init_and_link("../resources/shaders/openwarp_mesh_stereo.vert", "../resources/shaders/openwarp_mesh_stereo.frag", stereoDefines);
+    stereoProgram.u_eye = glGetUniformLocation(stereoProgram.program, "u_eye");
+    stereoProgram.u_renderInverseP = glGetUniformLocation(stereoProgram.program, "u_renderInverseP");
+    stereoProgram.u_renderInverseV = glGetUniformLocation(stereoProgram.program, "u_renderInverseV");
+    stereoProgram.u_bleedRadius = glGetUniformLocation(stereoProgram.program, "bleedRadius");
+    stereoProgram.u_bleedTolerance = glGetUniformLocation(stereoProgram.program, "edgeTolerance");
+    stereoProgram.u_debugOpacity = glGetUniformLocation(stereoProgram.program, "u_debugOpacity");
+    stereoProgram.mesh_vertices_vbo = 0;
+    stereoProgram.mesh_indices_vbo = 0;
+    stereoProgram.num_indices = 0;
+
+    glGenTextures(1, &stereoProgram.output_color);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, stereoProgram.output_color);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, EYE_WIDTH, HEIGHT, NUM_EYES);
+    glGenTextures(1, &stereoProgram.output_depth);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, stereoProgram.output_depth);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT32F, EYE_WIDTH, HEIGHT, NUM_EYES);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // Multiview and layered rendering attach every layer at once; the
+    // per-eye fallback attaches one layer at a time, as it draws.
+    glGenFramebuffers(1, &stereoProgram.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, stereoProgram.fbo);
+    if(stereoProgram.path == StereoPath::Multiview) {
+        glFramebufferTextureMultiviewOVR(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, stereoProgram.output_color, 0, 0, NUM_EYES);
+        glFramebufferTextureMultiviewOVR(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, stereoProgram.output_depth, 0, 0, NUM_EYES);
+    } else if(stereoProgram.path == StereoPath::Layered) {
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, stereoProgram.output_color, 0);
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, stereoProgram.output_depth, 0);
+    }
+    // One layer each, for warps that handle a single eye.
+    for(int e = 0; e < NUM_EYES; e++) {
+        glGenFramebuffers(1, &stereoProgram.eye_fbo[e]);
+        glBindFramebuffer(GL_FRAMEBUFFER, stereoProgram.eye_fbo[e]);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, stereoProgram.output_color, 0, e);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, stereoProgram.output_depth, 0, e);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    glGenBuffers(1, &meshProgram.mesh_indices_vbo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshProgram.mesh_indices_vbo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, meshProgram.mesh_indices.size() * sizeof(GLuint), &meshProgram.mesh_indices.at(0), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    // Build the reprojection mesh for mesh-based Openwarp,
+    // and make it the active mesh.
+    SetMeshSize(meshWidth);
 
     // Openwarp-ray rendering initialization
     //////////////////////////////
@@ -568,22 +2260,63 @@ int OpenwarpApplication::initGL(){
     // Build and link shaders for openwarp-ray.
 	rayProgram.program = init_and_link("../resources/shaders/openwarp_ray.vert", "../resources/shaders/openwarp_ray.frag");
 
-    // Get the color + depth samplers
-    rayProgram.eye_sampler = glGetUniformLocation(rayProgram.program, "Texture");
-    rayProgram.depth_sampler = glGetUniformLocation(rayProgram.program, "_Depth");
+    getRayUniforms(rayProgram);
 
-    // Get the warp matrix uniforms
-    // Inverse V and P matrices of the rendered pose
-    rayProgram.u_renderPV = glGetUniformLocation(rayProgram.program, "u_renderPV");
-    rayProgram.u_warpInverseVP = glGetUniformLocation(rayProgram.program, "u_warpInverseVP");
-    rayProgram.u_warpPos = glGetUniformLocation(rayProgram.program, "u_warpPos");
+    // Tiled compute-shader variant of openwarp-ray, with the same uniforms.
+    // It writes to its own color target, which is then blitted to the screen.
+    rayComputeProgram.program = init_and_link_compute("../resources/shaders/openwarp_ray.comp");
+    getRayUniforms(rayComputeProgram);
 
-    rayProgram.u_power = glGetUniformLocation(rayProgram.program, "u_power");
-    rayProgram.u_stepSize = glGetUniformLocation(rayProgram.program, "u_stepSize");
-    rayProgram.u_depthOffset = glGetUniformLocation(rayProgram.program, "u_depthOffset");
-    rayProgram.u_occlusionThreshold = glGetUniformLocation(rayProgram.program, "u_occlusionThreshold");
-    rayProgram.u_occlusionOffset = glGetUniformLocation(rayProgram.program, "u_occlusionOffset");
+    glGenTextures(1, &rayOutputTexture);
+    glBindTexture(GL_TEXTURE_2D, rayOutputTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, WIDTH, HEIGHT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // The hybrid warp also draws the mesh warp into it, which needs depth.
+    glGenRenderbuffers(1, &rayOutputDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, rayOutputDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, WIDTH, HEIGHT);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &rayOutputFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, rayOutputFBO);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, rayOutputTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rayOutputDepth);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+    // Start with no reusable hits.
+    glGenTextures(1, &rayHistoryTexture);
+    glBindTexture(GL_TEXTURE_2D, rayHistoryTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, WIDTH, HEIGHT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glClearTexImage(rayHistoryTexture, 0, GL_RGBA, GL_FLOAT, NULL);
+
+    // Hybrid warp tile classification.
+    hybridProgram.classify.program = init_and_link_compute("../resources/shaders/openwarp_hybrid_classify.comp");
+    getRayUniforms(hybridProgram.classify);
+    hybridProgram.u_outputSize = glGetUniformLocation(hybridProgram.classify.program, "u_outputSize");
+    hybridProgram.u_discontinuityThreshold = glGetUniformLocation(hybridProgram.classify.program, "u_discontinuityThreshold");
+
+    // Room for the dispatch arguments, plus every tile.
+    glGenBuffers(1, &hybridProgram.tile_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, hybridProgram.tile_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (3 + ((WIDTH + 15) / 16) * ((HEIGHT + 15) / 16)) * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // Reduced-resolution openwarp-ray, and its upsample pass.
+    rayReducedProgram.march.program = init_and_link_compute("../resources/shaders/openwarp_ray_lowres.comp");
+    getRayUniforms(rayReducedProgram.march);
+    rayReducedProgram.u_marchSize = glGetUniformLocation(rayReducedProgram.march.program, "u_marchSize");
+
+    glGenTextures(1, &rayReducedProgram.hit_texture);
+    glBindTexture(GL_TEXTURE_2D, rayReducedProgram.hit_texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, WIDTH / 2, HEIGHT / 2);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenVertexArrays(1, &rayReducedProgram.vao);
+    rayReducedProgram.upsample_program = init_and_link("../resources/shaders/openwarp_fullscreen.vert", "../resources/shaders/openwarp_ray_upsample.frag");
+    rayReducedProgram.u_lowResSize = glGetUniformLocation(rayReducedProgram.upsample_program, "u_lowResSize");
+    rayReducedProgram.u_depthSigma = glGetUniformLocation(rayReducedProgram.upsample_program, "u_depthSigma");
 
     // Generate, bind, and fill mesh VBOs.
     glGenBuffers(1, &rayProgram.mesh_vertices_vbo);
@@ -596,6 +2329,48 @@ int OpenwarpApplication::initGL(){
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, rayProgram.mesh_indices.size() * sizeof(GLuint), &rayProgram.mesh_indices.at(0), GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+    // Planar reprojection plane fit initialization
+    //////////////////////////////
+
+    createRenderTexture(&planeFit.depth_texture, PLANE_FIT_SIZE, PLANE_FIT_SIZE, true);
+
+    // Openwarp homography (rotation-only fast path) initialization
+    //////////////////////////////
+
+    // Attribute-less; only needs an empty VAO bound to draw.
+    glGenVertexArrays(1, &homographyProgram.vao);
+
+    homographyProgram.program = init_and_link("../resources/shaders/openwarp_fullscreen.vert", "../resources/shaders/openwarp_homography.frag");
+    homographyProgram.eye_sampler = glGetUniformLocation(homographyProgram.program, "Texture");
+
+    // Openwarp forward-splat initialization
+    //////////////////////////////
+
+    glGenTextures(1, &splatProgram.depth_image);
+    glBindTexture(GL_TEXTURE_2D, splatProgram.depth_image);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, WIDTH, HEIGHT);
+    glGenTextures(1, &splatProgram.uv_image);
+    glBindTexture(GL_TEXTURE_2D, splatProgram.uv_image);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32F, WIDTH, HEIGHT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    splatProgram.program = init_and_link_compute("../resources/shaders/openwarp_splat.comp");
+    splatProgram.u_pass = glGetUniformLocation(splatProgram.program, "u_pass");
+    splatProgram.u_splatSize = glGetUniformLocation(splatProgram.program, "u_splatSize");
+    splatProgram.u_renderInverseP = glGetUniformLocation(splatProgram.program, "u_renderInverseP");
+    splatProgram.u_renderInverseV = glGetUniformLocation(splatProgram.program, "u_renderInverseV");
+
+    glGenVertexArrays(1, &splatProgram.vao);
+    splatProgram.resolve_program = init_and_link("../resources/shaders/openwarp_fullscreen.vert", "../resources/shaders/openwarp_splat.frag");
+    splatProgram.u_holeFillRadius = glGetUniformLocation(splatProgram.resolve_program, "u_holeFillRadius");
+
+    stallProgram.program = init_and_link_compute("../resources/shaders/openwarp_stall.comp");
+    stallProgram.u_iterations = glGetUniformLocation(stallProgram.program, "u_iterations");
+    glGenBuffers(1, &stallProgram.sink);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, stallProgram.sink);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
     // Upload the projection matrix (and inverse projection matrix) to the
     // demo and openwarp-mesh programs. Should only need to do this once;
     // we won't be changing this projection matrix at runtime (non-resizeable window)
@@ -606,9 +2381,298 @@ int OpenwarpApplication::initGL(){
     glUseProgram(rayProgram.program);
     glUseProgram(0);
 
+    // Eye buffers, on the render context.
+    runOnRenderContext([this]{ initRenderContext(); });
+
     return 0;
 }
 
+void OpenwarpApplication::initRenderContext(){
+
+    // Debug output is per-context.
+    glEnable              ( GL_DEBUG_OUTPUT );
+    glDebugMessageCallback( MessageCallback, 0 );
+
+    // Create and bind global VAO object
+    glGenVertexArrays(1, &demoVAO);
+    glBindVertexArray(demoVAO);
+
+    glGenVertexArrays(1, &linearizeProgram.vao);
+
+    stallProgram.timer.Init();
+    sceneTimer.Init();
+    depthPrepTimer.Init();
+
+    glGenFramebuffers(1, &planeFit.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, planeFit.fbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, planeFit.depth_texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    for(auto& eye : eyeBuffers) {
+        // Create both color and depth render textures
+        createRenderTexture(&eye.color_texture, WIDTH, HEIGHT, false);
+        createRenderTexture(&eye.depth_texture, WIDTH, HEIGHT, true);
+
+        // Create FBO that will render to them!
+        createFBO(&eye.color_texture, &eye.fbo, &eye.depth_texture, &eye.depth_target, WIDTH, HEIGHT);
+
+        // Linear depth, shared by the depth-based warps.
+        glGenFramebuffers(1, &eye.linear_depth_fbo);
+        eye.linear_depth_texture = 0;
+        createLinearDepthTexture(eye);
+
+        glGenTextures(1, &eye.hiz_texture);
+        glBindTexture(GL_TEXTURE_2D, eye.hiz_texture);
+        glTexStorage2D(GL_TEXTURE_2D, hizLevels, GL_RG32F, WIDTH, HEIGHT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glGenBuffers(1, &eye.plane_fit_pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, eye.plane_fit_pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, PLANE_FIT_SIZE * PLANE_FIT_SIZE * sizeof(GLfloat), NULL, GL_STREAM_READ);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // Stereo eyes, as layers. Their attachments are
+        // switched per eye while rendering.
+        glGenTextures(1, &eye.stereo_color_array);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, eye.stereo_color_array);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, EYE_WIDTH, HEIGHT, NUM_EYES);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glGenTextures(1, &eye.stereo_depth_array);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, eye.stereo_depth_array);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT32F, EYE_WIDTH, HEIGHT, NUM_EYES);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glGenFramebuffers(1, &eye.stereo_fbo);
+    }
+}
+
 int OpenwarpApplication::cleanupGL(){
+    for(auto& mesh : meshCache) {
+        glDeleteBuffers(1, &mesh.vertices_vbo);
+        glDeleteBuffers(1, &mesh.indices_vbo);
+    }
+    meshCache.clear();
+    warpTimer.Cleanup();
+    latePose.Cleanup();
+
+    // Objects that only exist on the render context.
+    runOnRenderContext([this]{
+        for(auto& eye : eyeBuffers) {
+            glDeleteFramebuffers(1, &eye.fbo);
+            glDeleteFramebuffers(1, &eye.linear_depth_fbo);
+            glDeleteFramebuffers(1, &eye.stereo_fbo);
+        }
+        glDeleteFramebuffers(1, &planeFit.fbo);
+        glDeleteVertexArrays(1, &linearizeProgram.vao);
+        stallProgram.timer.Cleanup();
+        sceneTimer.Cleanup();
+        depthPrepTimer.Cleanup();
+        glDeleteVertexArrays(1, &demoVAO);
+    });
+
+    for(auto& eye : eyeBuffers) {
+        for(GLsync fence : { eye.plane_fit_fence, eye.render_fence, eye.warp_fence }) {
+            if(fence) {
+                glDeleteSync(fence);
+            }
+        }
+        glDeleteTextures(1, &eye.color_texture);
+        glDeleteTextures(1, &eye.depth_texture);
+        glDeleteRenderbuffers(1, &eye.depth_target);
+        glDeleteTextures(1, &eye.linear_depth_texture);
+        glDeleteTextures(1, &eye.hiz_texture);
+        glDeleteBuffers(1, &eye.plane_fit_pbo);
+        glDeleteTextures(1, &eye.stereo_color_array);
+        glDeleteTextures(1, &eye.stereo_depth_array);
+    }
+    glDeleteFramebuffers(1, &presentFBO);
+    glDeleteFramebuffers(1, &lastWarpFBO);
+    glDeleteTextures(1, &lastWarpTexture);
+    glDeleteFramebuffers(1, &frontBufferFBO);
+    glDeleteTextures(1, &frontBufferTexture);
+    glDeleteTextures(1, &frontBufferDepth);
+    glDeleteFramebuffers(1, &stereoProgram.fbo);
+    glDeleteFramebuffers(NUM_EYES, stereoProgram.eye_fbo);
+    glDeleteTextures(1, &stereoProgram.output_color);
+    glDeleteTextures(1, &stereoProgram.output_depth);
+    glDeleteVertexArrays(1, &stereoProgram.vao);
+    glDeleteTextures(1, &planeFit.depth_texture);
+    glDeleteTextures(1, &splatProgram.depth_image);
+    glDeleteTextures(1, &splatProgram.uv_image);
+    glDeleteTextures(1, &rayReducedProgram.hit_texture);
+    glDeleteTextures(1, &rayHistoryTexture);
+    glDeleteFramebuffers(1, &rayOutputFBO);
+    glDeleteRenderbuffers(1, &rayOutputDepth);
+    glDeleteBuffers(1, &hybridProgram.tile_buffer);
+    glDeleteBuffers(1, &stallProgram.sink);
+    glDeleteTextures(1, &rayOutputTexture);
     return 0;
+}
+
+void OpenwarpApplication::getRayUniforms(owRayProgram& ray){
+    // Get the color + depth samplers
+    ray.eye_sampler = glGetUniformLocation(ray.program, "Texture");
+    ray.depth_sampler = glGetUniformLocation(ray.program, "_LinearDepth");
+
+    // Get the warp matrix uniforms
+    // Inverse V and P matrices of the rendered pose
+    ray.u_renderPV = glGetUniformLocation(ray.program, "u_renderPV");
+    ray.u_near = glGetUniformLocation(ray.program, "u_near");
+
+    ray.u_power = glGetUniformLocation(ray.program, "u_power");
+    ray.u_stepSize = glGetUniformLocation(ray.program, "u_stepSize");
+    ray.u_depthOffset = glGetUniformLocation(ray.program, "u_depthOffset");
+    ray.u_occlusionThreshold = glGetUniformLocation(ray.program, "u_occlusionThreshold");
+    ray.u_occlusionOffset = glGetUniformLocation(ray.program, "u_occlusionOffset");
+
+    ray.u_maxIterations = glGetUniformLocation(ray.program, "u_maxIterations");
+    ray.u_convergenceThreshold = glGetUniformLocation(ray.program, "u_convergenceThreshold");
+    ray.u_deferredColor = glGetUniformLocation(ray.program, "u_deferredColor");
+    ray.u_debugIterations = glGetUniformLocation(ray.program, "u_debugIterations");
+
+    ray.u_useHiZ = glGetUniformLocation(ray.program, "u_useHiZ");
+    ray.u_hizMaxLevel = glGetUniformLocation(ray.program, "u_hizMaxLevel");
+    ray.u_hizRefineIterations = glGetUniformLocation(ray.program, "u_hizRefineIterations");
+
+    ray.u_useHistory = glGetUniformLocation(ray.program, "u_useHistory");
+    ray.u_historyIterations = glGetUniformLocation(ray.program, "u_historyIterations");
+    ray.u_historyTolerance = glGetUniformLocation(ray.program, "u_historyTolerance");
+
+    ray.u_adaptiveIterations = glGetUniformLocation(ray.program, "u_adaptiveIterations");
+    ray.u_parallaxScale = glGetUniformLocation(ray.program, "u_parallaxScale");
+    ray.u_iterationsPerPixel = glGetUniformLocation(ray.program, "u_iterationsPerPixel");
+    ray.u_minIterations = glGetUniformLocation(ray.program, "u_minIterations");
+
+    ray.u_useTileList = glGetUniformLocation(ray.program, "u_useTileList");
+    ray.u_showTiles = glGetUniformLocation(ray.program, "u_showTiles");
+    ray.u_adaptivePerTile = glGetUniformLocation(ray.program, "u_adaptivePerTile");
+}
+
+void OpenwarpApplication::SetMeshSize(size_t meshSize){
+    meshSize = std::clamp(meshSize, minMeshSize, maxMeshSize);
+
+    // Each eye gets half the columns. Acquired first, so that the mono
+    // mesh still ends up at the front of the cache.
+    if(useStereo) {
+        const owMeshBuffers& eyeMesh = acquireMesh(std::max(meshSize / 2, minMeshSize), meshSize);
+        stereoProgram.mesh_vertices_vbo = eyeMesh.vertices_vbo;
+        stereoProgram.mesh_indices_vbo = eyeMesh.indices_vbo;
+        stereoProgram.num_indices = eyeMesh.num_indices;
+    }
+
+    const owMeshBuffers& mesh = acquireMesh(meshSize, meshSize);
+    meshProgram.mesh_vertices_vbo = mesh.vertices_vbo;
+    meshProgram.mesh_indices_vbo = mesh.indices_vbo;
+    meshProgram.num_indices = mesh.num_indices;
+
+    meshWidth = mesh.width;
+    meshHeight = mesh.height;
+
+    // Adjust meshwarp bleed radius according to mesh size.
+    bleedRadius = (1.0f/(meshWidth));
+}
+
+void OpenwarpApplication::EnableGovernor(const std::string& logPath){
+    if(!logPath.empty() && !governor.OpenLog(logPath)) {
+        std::cerr << "Could not open governor log " << logPath << std::endl;
+    }
+    userQuality = {"User", warpAlgorithm, meshWidth, rayMaxIterations, rayResolutionDivisor};
+    useGovernor = true;
+    governor.budgetMs = warpBudgetMs;
+    governor.SetLevel(0);
+    applyQualityLevel(governor.Current());
+}
+
+bool OpenwarpApplication::EnableStallProfile(const std::string& profilePath){
+    if(!stallInjector.LoadProfile(profilePath)) {
+        return false;
+    }
+    StallSettings settings = stallInjector.Settings();
+    settings.mode = StallMode::Recorded;
+    stallInjector.Configure(settings);
+    return true;
+}
+
+void OpenwarpApplication::applyQualityLevel(const QualityLevel& quality){
+    warpAlgorithm = quality.algorithm;
+    SetMeshSize(quality.meshSize);
+    rayMaxIterations = quality.rayMaxIterations;
+    rayResolutionDivisor = quality.rayResolutionDivisor;
+    budgetFallbackActive = false;
+}
+
+const OpenwarpApplication::owMeshBuffers& OpenwarpApplication::acquireMesh(size_t width, size_t height){
+
+    // Cache hit; move to the front of the LRU list.
+    for(auto it = meshCache.begin(); it != meshCache.end(); it++) {
+        if(it->width == width && it->height == height) {
+            meshCache.splice(meshCache.begin(), meshCache, it);
+            return meshCache.front();
+        }
+    }
+
+    // Cache miss; evict the least recently used mesh if we're full.
+    // The active meshes (mono, and in stereo the per-eye one) are always
+    // at the front, so they are never evicted.
+    if(meshCache.size() >= meshCacheCapacity) {
+        owMeshBuffers& evicted = meshCache.back();
+        glDeleteBuffers(1, &evicted.vertices_vbo);
+        glDeleteBuffers(1, &evicted.indices_vbo);
+        meshCache.pop_back();
+    }
+
+    owMeshBuffers mesh;
+    mesh.width = width;
+    mesh.height = height;
+
+    // Upload geometry straight out of the on-disk cache if we can;
+    // otherwise build it (and cache it for next time).
+    // The CPU-side copies are discarded once uploaded.
+    MappedMesh cached;
+    std::vector<vertex_t> vertices;
+    std::vector<GLuint> indices;
+    const vertex_t* vertex_data;
+    const GLuint* index_data;
+    size_t num_vertices;
+
+    if(!meshCacheDir.empty() && cached.Load(meshCacheDir, width, height)) {
+        vertex_data = cached.vertices;
+        num_vertices = cached.num_vertices;
+        index_data = cached.indices;
+        mesh.num_indices = cached.num_indices;
+    } else {
+        BuildMesh(width, height, indices, vertices);
+        if(!meshCacheDir.empty() && !StoreCachedMesh(meshCacheDir, width, height, indices, vertices)) {
+            std::cerr << "Failed to write reprojection mesh to cache dir " << meshCacheDir << std::endl;
+        }
+        vertex_data = vertices.data();
+        num_vertices = vertices.size();
+        index_data = indices.data();
+        mesh.num_indices = indices.size();
+    }
+
+    // Generate, bind, and fill mesh VBOs.
+    glGenBuffers(1, &mesh.vertices_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vertices_vbo);
+    glBufferData(GL_ARRAY_BUFFER, num_vertices * sizeof(vertex_t), vertex_data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &mesh.indices_vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indices_vbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.num_indices * sizeof(GLuint), index_data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    meshCache.push_front(mesh);
+    return meshCache.front();
 }
\ No newline at end of file
@@ -20,9 +20,26 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdint>
+#include <list>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include "openwarp.hpp"
 #include "util/obj.hpp"
+#include "util/gpu_timer.hpp"
+#include "util/frame_pacer.hpp"
+#include "util/beam_racer.hpp"
+#include "util/late_latch.hpp"
+#include "util/mesh.hpp"
+#include "util/governor.hpp"
+#include "util/pose_predictor.hpp"
+#include "util/pose_provider.hpp"
+#include "util/stall_injector.hpp"
+#include "util/timing.hpp"
+#include "util/vsync_scheduler.hpp"
 #include "testrun.hpp"
 
 class Openwarp::OpenwarpApplication{
@@ -31,13 +48,34 @@ class Openwarp::OpenwarpApplication{
     const uint32_t HEIGHT = 1024;
 
     public:
-        OpenwarpApplication(size_t meshSize = 1024);
+        // If meshCacheDir is non-empty, built reprojection meshes are cached
+        // on disk there and memory-mapped on subsequent runs.
+        OpenwarpApplication(size_t meshSize = 1024, std::string meshCacheDir = "");
         ~OpenwarpApplication();
 
         void Run(bool showGUI);
 
-        void DoFullTestRun(const TestRun& testRun);
-        void RunTest(const TestRun& testRun, std::string runDir, bool isGroundTruth, bool testUsesRay);
+        void DoFullTestRun(const TestRun& testRun, WarpAlgorithm testAlgorithm = WarpAlgorithm::Mesh);
+        void RunTest(const TestRun& testRun, std::string runDir, bool isGroundTruth, WarpAlgorithm testAlgorithm);
+
+        // Render true stereo at each test pose, and stereo synthesized from a
+        // mono frame at the same pose (with synthAlgorithm, the mesh or ray
+        // warp). Writes both, and the PSNR between them and the scene GPU time
+        // of each, to the run dir.
+        void DoStereoTestRun(const TestRun& testRun, WarpAlgorithm synthAlgorithm = WarpAlgorithm::Mesh);
+
+        // Swap the openwarp-mesh reprojection mesh to a new resolution.
+        // Previously built meshes are kept on the GPU, so switching
+        // back to a recently used size is free.
+        void SetMeshSize(size_t meshSize);
+
+        // Turn on the frame-budget governor, logging its decisions
+        // to logPath as CSV (no log if the path is empty).
+        void EnableGovernor(const std::string& logPath);
+
+        // Inject render stalls replaying the frame times in profilePath
+        // (see StallInjector::LoadProfile). Returns false if it can't be loaded.
+        bool EnableStallProfile(const std::string& profilePath);
 
         static OpenwarpApplication* instance;
 
@@ -53,23 +91,72 @@ class Openwarp::OpenwarpApplication{
 
         bool showMeshConfig = true;
         bool showRayConfig = true;
+        bool showReprojectionConfig = true;
         bool useVsync = false;
 
         // Application resources
         ObjScene demoscene;
         Eigen::Matrix4f projection;
+        // Pose integrated from keyboard and mouse input, main thread only.
+        // Everything else reads poses from the active provider's history.
         Eigen::Vector3f position = Eigen::Vector3f(0,0,0);
         Eigen::Quaternionf orientation = Eigen::Quaternionf::Identity();
+
+        // Pose sources. processInput() always feeds inputPoseProvider;
+        // the synthetic one runs its own high-rate thread while selected.
+        InputPoseProvider inputPoseProvider;
+        SyntheticPoseProvider syntheticPoseProvider;
+        std::atomic<PoseProvider*> poseProvider = &inputPoseProvider;
+
+        // Predict the pose at photon time; one predictor per consuming
+        // thread, so neither needs a lock. Settings are shared.
+        PosePredictor renderPredictor;
+        PosePredictor warpPredictor;
+        std::atomic<PredictionMode> predictionMode = PredictionMode::ConstantVelocity;
+        std::atomic<float> predictionSmoothing = 0.6f;
+
+        // Expected time from sampling a frame's render pose to its first
+        // warp being presented, measured in Run() and read by the renderer.
+        std::atomic<double> renderPhotonLatency = 0.05;
+        uint64_t latencyFrameId = 0;
+
         Eigen::Matrix4f renderedView;
         Eigen::Matrix4f renderedCameraMatrix;
 
+        // Stereo. Each eye is EYE_WIDTH x HEIGHT, shown side by side in the
+        // window, with an off-axis projection and a camera offset by half
+        // the IPD from the head pose. The render thread reads the settings.
+        static const int NUM_EYES = 2;
+        const uint32_t EYE_WIDTH = WIDTH / 2;
+        std::atomic<bool> useStereo = false;
+        std::atomic<float> ipd = 0.064f;
+
+        // Render only a centre view, and synthesize both eyes from it.
+        std::atomic<bool> stereoFromMono = false;
+
+        // GPU time of drawing the scene (one view, or both eyes), to show
+        // what stereo from mono saves; and of the depth preparation mono
+        // frames get for the warp (linearize, plane fit, Hi-Z), which
+        // stereo frames skip. Render context only; the averages are
+        // published for the GUI.
+        GpuTimer sceneTimer;
+        GpuTimer depthPrepTimer;
+        std::atomic<double> sceneGpuMs = 0.0;
+        std::atomic<double> depthPrepGpuMs = 0.0;
+        float stereoAsymmetry = 0.15f;
+        Eigen::Matrix4f eyeProjection[NUM_EYES];
+
         double nextRenderTime = 0.0f;
         double renderFPS = 15.0f;
-        double renderInterval = (1/renderFPS);
+        std::atomic<double> renderInterval = (1/renderFPS);
 
         size_t meshWidth = 1024;
         size_t meshHeight = 1024;
 
+        // Smallest and largest mesh sizes selectable at runtime.
+        const size_t minMeshSize = 8;
+        const size_t maxMeshSize = 4096;
+
         // Hand-tuned parameters
         float bleedRadius = 0.005f;
         float bleedTolerance = 0.0001f;
@@ -77,32 +164,254 @@ class Openwarp::OpenwarpApplication{
         // Hand-tuned parameters
         float rayPower = 0.5f;
         float rayStepSize = 0.242f;
-        float rayDepthOffset = 0.379f;
-        float occlusionThreshold = 0.02f;
+        float rayDepthOffset = 0.758f;
+        float occlusionThreshold = 0.01f;
         float occlusionOffset = 0.388f;
 
+        // Ray iteration budget and early termination
+        int rayMaxIterations = 32;
+        float rayConvergenceThreshold = 0.001f;
+        bool rayDeferredColor = false;
+        bool rayDebugIterations = false;
+
+        // Adaptive iteration budget. Each ray gets rayMinIterations, plus
+        // rayIterationsPerPixel per pixel of the largest parallax the pose
+        // delta can cause over the depth range, up to rayMaxIterations.
+        // The compute path can bound the depth range per tile.
+        bool rayAdaptiveIterations = true;
+        bool rayAdaptivePerTile = true;
+        int rayMinIterations = 4;
+        float rayIterationsPerPixel = 0.5f;
+
+        // Hierarchical (Hi-Z) ray tracing
+        bool rayUseHiZ = true;
+        int rayHiZRefineIterations = 4;
+
+        // Run the raymarch as a tiled compute shader, with each tile's
+        // depth footprint cached in shared memory, instead of per fragment.
+        bool rayUseCompute = false;
+
+        // March at a fraction of the output resolution (1, 2 or 4), then
+        // upsample with a depth-guided joint-bilateral filter.
+        int rayResolutionDivisor = 1;
+        float rayUpsampleDepthSigma = 0.05f;
+
+        // Temporal reuse: start each full-resolution ray from the previous
+        // warp's hit, and only march in full where that doesn't hold up.
+        bool rayUseHistory = false;
+        int rayHistoryIterations = 3;
+        float rayHistoryTolerance = 0.01f;
+
         bool showDebugGrid = false;
 
-        bool shouldRenderScene = true;
+        // Rotation-only fast path. When the fresh pose has (nearly) the
+        // same position as the rendered pose, depth doesn't matter, and a
+        // single homography reproduces the full warp.
+        bool useRotationFastPath = true;
+        float rotationOnlyThreshold = 0.001f;
+
+        // How often the rotation-only fast path triggers.
+        uint64_t warpCount = 0;
+        uint64_t rotationOnlyWarpCount = 0;
+
+        std::atomic<bool> shouldRenderScene = true;
         bool shouldReproject = true;
-        bool useRay = false;
+        WarpAlgorithm warpAlgorithm = WarpAlgorithm::Mesh;
+
+        // Planar reprojection parameters. The plane is either fixed
+        // at planarFocalDistance along the view axis, or fitted to a
+        // downsampled copy of the rendered depth buffer.
+        bool planarUseFittedPlane = true;
+        float planarFocalDistance = 3.0f;
+
+        // Emergency fallback: switch to planar reprojection if the
+        // warp pass goes over budget.
+        bool useBudgetFallback = false;
+        float warpBudgetMs = 4.0f;
+        bool budgetFallbackActive = false;
+
+        // Frame-budget governor. When enabled it replaces the one-shot
+        // fallback above, stepping the warp down a ladder of quality
+        // levels when over budget, and back up when there's headroom.
+        bool useGovernor = false;
+        WarpGovernor governor;
+
+        // The quality settings from before the governor took over, put
+        // back when test runs turn it off.
+        QualityLevel userQuality;
+
+        // warpTimer results the governor has seen; it only takes new ones.
+        uint64_t governorTimerResults = 0;
 
         double lastSwapTime;
         double presentationFramerate;
 
+        // Just-in-time warp. With vsync on, sleep until the frame only just
+        // makes the next vsync, instead of warping straight away and then
+        // blocking in the swap.
+        bool useWarpScheduler = true;
+        VsyncScheduler vsyncScheduler;
+
+        // Pacing for when vsync is off, and the loop would otherwise spin,
+        // re-warping and swapping as fast as it can.
+        PacingMode pacingMode = PacingMode::Spin;
+        FramePacer framePacer;
+
+        // The last warped frame, kept for SkipUnchanged to re-present.
+        GLuint lastWarpTexture;
+        GLuint lastWarpFBO;
+
+        // Beam racing. The frame is warped in horizontal slices, each from
+        // its own pose, just ahead of a virtual rolling scanout, into a
+        // stand-in for the front buffer that is shown once it's complete.
+        bool useBeamRacing = false;
+        BeamRacer beamRacer;
+        GLuint frontBufferTexture;
+        GLuint frontBufferDepth;
+        GLuint frontBufferFBO;
+
+        // Times the reprojection pass on the GPU.
+        GpuTimer warpTimer;
+
+        // The fresh pose every warp shader reads (WarpPose, uniform
+        // binding 0). With late latching, the pose is sampled again once
+        // the warp has been issued and rewritten just before the flush.
+        LateLatchBuffer latePose;
+        bool useLateLatch = true;
+        static const GLuint WARP_POSE_BINDING = 0;
+
+        // Which homography the homography warp uses. It's a function of
+        // the fresh pose, so it is recomputed whenever the pose is latched.
+        enum class HomographyMode { None, Rotation, Plane };
+        HomographyMode homographyMode = HomographyMode::None;
+
         // GLFW resources
         GLFWwindow* window;
+        // Hidden window, only for its GL context, which shares objects
+        // with window's. The scene is rendered on this context.
+        GLFWwindow* renderContext;
         // Need to init so that we don't
         // get uninitialized errors
         double lastInputTime = glfwGetTime();
 
         // OpenGL resources
 
-        // Demo render resources
+        enum class EyeBufferState {
+            Free,       // Nothing worth warping in it.
+            Rendering,  // Owned by the renderer.
+            Ready,      // Holds a published frame.
+        };
+
+        // Everything the warp needs from one rendered frame. FBOs are not
+        // shared between contexts, so those only exist on the render context.
+        typedef struct owEyeBuffer {
+            EyeBufferState state = EyeBufferState::Free;
+
+            // Frame metadata: a per-frame counter, starting at 1,
+            // and when the frame's pose was sampled (glfwGetTime()).
+            uint64_t frame_id = 0;
+            double render_time = 0.0;
+
+            GLuint color_texture;
+            GLuint depth_texture;
+            GLuint depth_target;
+            GLuint fbo;
+
+            // Linear view-space depth of depth_texture, shared by the
+            // depth-based warps. Optionally half precision, to save bandwidth.
+            GLuint linear_depth_texture;
+            GLuint linear_depth_fbo;
+
+            // Hierarchical min/max depth pyramid of linear_depth_texture.
+            GLuint hiz_texture;
+
+            // Asynchronous readback of the depth, for the planar warp's
+            // plane fit. The fence is signalled once it has landed.
+            GLuint plane_fit_pbo;
+            GLsync plane_fit_fence = 0;
+
+            // Pose the frame was rendered at.
+            Eigen::Matrix4f camera_matrix = Eigen::Matrix4f::Identity();
+
+            // Stereo frames render each eye into a layer of these arrays
+            // instead, left eye first, at the per-eye camera matrices.
+            bool stereo = false;
+            GLuint stereo_color_array;
+            GLuint stereo_depth_array;
+            GLuint stereo_fbo;
+            Eigen::Matrix4f eye_camera_matrix[NUM_EYES];
+
+            // Signalled when rendering into / the last warp out of
+            // this eye buffer has finished on the GPU.
+            GLsync render_fence = 0;
+            GLsync warp_fence = 0;
+        } owEyeBuffer;
+
+        // Ring of eye buffers. With three, the renderer always has one
+        // to draw into while the warp reads another and a third holds
+        // the newest published frame, so neither side waits on the other.
+        static const int NUM_EYE_BUFFERS = 3;
+        owEyeBuffer eyeBuffers[NUM_EYE_BUFFERS];
+        uint64_t nextFrameId = 1;
+
+        // Eye buffer the warp is currently reading; -1 if none. This, and
+        // the eye buffers' state and metadata, are guarded by eyeBufferMutex.
+        int warpingEyeBuffer = -1;
+        std::mutex eyeBufferMutex;
+        std::condition_variable eyeBufferCondition;
+
+        // Frame id and render time of the last eye buffer warped.
+        uint64_t warpedFrameId = 0;
+        double warpedFrameTime = 0.0;
+
+        // How often a presented frame had to re-warp an eye buffer that
+        // was already shown, and how old eye buffers are when presented.
+        uint64_t presentedFrameCount = 0;
+        uint64_t reusedFrameCount = 0;
+        double presentedAgeMs = 0.0;
+
+        // Deliberately slows down or drops rendered frames.
+        StallInjector stallInjector;
+
+        // Render thread. When it isn't running, Run() renders in line
+        // on the main thread instead, by switching contexts.
+        bool useRenderThread = true;
+        std::thread renderThread;
+        bool stopRenderThread = false;
+
+        // How often the render thread had to wait for the warp to
+        // release an eye buffer before it could start a frame.
+        std::atomic<uint64_t> renderStallCount = 0;
+
+        // The eye buffer currently being warped; its textures and pose
+        // are latched here by acquireWarpSource().
         GLuint renderTexture;
         GLuint depthTexture;
-        GLuint renderFBO;
-        GLuint renderDepthTarget;
+        GLuint linearDepthTexture;
+        GLuint hizTexture;
+        bool warpingStereo = false;
+        GLuint stereoColorArray;
+        GLuint stereoDepthArray;
+        Eigen::Matrix4f renderedEyeCameraMatrix[NUM_EYES];
+
+        bool linearDepthHalfFloat = false;
+
+        // Reads eye buffers to the screen when reprojection is off.
+        GLuint presentFBO;
+
+        typedef struct owLinearizeProgram {
+            GLint program;
+            GLint u_near;
+            GLint u_far;
+            GLuint vao;
+        } owLinearizeProgram;
+
+        owLinearizeProgram linearizeProgram;
+
+        // Mip levels of each eye buffer's depth pyramid.
+        GLint hizLevels;
+        GLint hizProgram;
+        GLint hizLevelAttr;
         GLint demoShaderProgram;
         GLuint demoVAO;
 
@@ -111,18 +420,38 @@ class Openwarp::OpenwarpApplication{
         GLuint demoModelViewAttr;
         GLuint demoProjectionAttr;
 
+        // GPU buffers for one reprojection mesh resolution.
+        typedef struct owMeshBuffers {
+            size_t width;
+            size_t height;
+            GLuint vertices_vbo;
+            GLuint indices_vbo;
+            GLsizei num_indices;
+        } owMeshBuffers;
+
+        // LRU cache of built reprojection meshes, most recently used first.
+        std::list<owMeshBuffers> meshCache;
+        const size_t meshCacheCapacity = 4;
+
+        // Directory of the on-disk mesh cache. Empty if disabled.
+        std::string meshCacheDir;
+
         typedef struct owMeshProgram {
             // Reprojection resources
-            // Reprojection mesh CPU buffers and GPU VBO handles
-            std::vector<vertex_t> mesh_vertices;
+            // GPU VBO handles of the currently active reprojection mesh.
+            // Owned by the mesh cache.
             GLuint mesh_vertices_vbo;
-            std::vector<GLuint> mesh_indices;
             GLuint mesh_indices_vbo;
+            GLsizei num_indices;
 
             // Color- and depth-samplers for openwarp
             GLint eye_sampler;
             GLint depth_sampler;
 
+            // Clip planes, to convert linear depth back to NDC
+            GLint u_near;
+            GLint u_far;
+
             // Mesh edge bleed parameters
             GLint u_bleedRadius;
             GLint u_bleedTolerance;
@@ -133,9 +462,6 @@ class Openwarp::OpenwarpApplication{
             GLuint u_renderInverseP;
             GLuint u_renderInverseV;
 
-            // VP matrix of the fresh pose
-            GLuint u_warp_vp;
-
             GLint program;
             GLuint vao;
         } owMeshProgram;
@@ -155,9 +481,7 @@ class Openwarp::OpenwarpApplication{
             GLint depth_sampler;
 
             GLuint u_renderPV;
-            GLuint u_warpInverseVP;
-
-            GLuint u_warpPos;
+            GLint u_near;
 
             GLuint u_power;
             GLuint u_stepSize;
@@ -165,19 +489,315 @@ class Openwarp::OpenwarpApplication{
             GLuint u_occlusionThreshold;
             GLuint u_occlusionOffset;
 
+            GLint u_maxIterations;
+            GLint u_convergenceThreshold;
+            GLint u_deferredColor;
+            GLint u_debugIterations;
+
+            GLint u_useHiZ;
+            GLint u_hizMaxLevel;
+            GLint u_hizRefineIterations;
+
+            GLint u_useHistory;
+            GLint u_historyIterations;
+            GLint u_historyTolerance;
+
+            GLint u_adaptiveIterations;
+            GLint u_parallaxScale;
+            GLint u_iterationsPerPixel;
+            GLint u_minIterations;
+
+            // Compute path only; -1 elsewhere.
+            GLint u_useTileList;
+            GLint u_showTiles;
+            GLint u_adaptivePerTile;
+
             GLint program;
             GLuint vao;
         } owRayProgram;
 
         owRayProgram rayProgram;
 
+        // Compute-shader raymarch. Shares owRayProgram's uniforms;
+        // the mesh buffers are unused.
+        owRayProgram rayComputeProgram;
+        GLuint rayOutputTexture;
+        GLuint rayOutputDepth;
+        GLuint rayOutputFBO;
+
+        // Per-pixel world-space ray hits (w = reusable) of the last warp,
+        // shared by the fragment and compute raymarch paths.
+        GLuint rayHistoryTexture;
+
+        typedef struct owRayReducedProgram {
+            // Low-resolution march. Shares owRayProgram's uniforms;
+            // the mesh buffers are unused.
+            owRayProgram march;
+            GLint u_marchSize;
+
+            // Per-ray hits, sized for half resolution. Quarter
+            // resolution only uses a corner of it.
+            GLuint hit_texture;
+
+            // Full-screen upsample program.
+            GLint upsample_program;
+            GLint u_lowResSize;
+            GLint u_depthSigma;
+            GLuint vao;
+        } owRayReducedProgram;
+
+        owRayReducedProgram rayReducedProgram;
+
+        // Hybrid warp parameters. Tiles whose depth varies by more than
+        // this (relative to the nearest depth) are raymarched.
+        float hybridDiscontinuityThreshold = 0.05f;
+        bool hybridShowTiles = false;
+
+        typedef struct owHybridProgram {
+            // Tile classification. Shares owRayProgram's uniforms,
+            // for the ray footprint bound; the mesh buffers are unused.
+            owRayProgram classify;
+            GLint u_outputSize;
+            GLint u_discontinuityThreshold;
+
+            // Indirect dispatch arguments for the compute raymarch,
+            // followed by the list of tiles it should march.
+            GLuint tile_buffer;
+        } owHybridProgram;
+
+        owHybridProgram hybridProgram;
+
+        typedef struct owHomographyProgram {
+            // Color sampler for the homography warp
+            GLint eye_sampler;
+
+            GLint program;
+            GLuint vao;
+        } owHomographyProgram;
+
+        owHomographyProgram homographyProgram;
+
+        // Forward-splatting parameters
+        int splatSize = 2;
+        int splatHoleFillRadius = 4;
+
+        typedef struct owSplatProgram {
+            // Per-output-pixel nearest splat depth (as uint bits), and the
+            // eye buffer UV of the splat that won the depth test.
+            GLuint depth_image;
+            GLuint uv_image;
+
+            // Compute program; scatters eye buffer texels into the images.
+            GLint program;
+            GLint u_pass;
+            GLint u_splatSize;
+            GLint u_renderInverseP;
+            GLint u_renderInverseV;
+
+            // Full-screen resolve + hole-fill program.
+            GLint resolve_program;
+            GLint u_holeFillRadius;
+            GLuint vao;
+        } owSplatProgram;
+
+        owSplatProgram splatProgram;
+
+        // GPU stalls are issued as chunks of identical dispatches, so
+        // timing one chunk tells how many make up the requested time.
+        static const GLint STALL_CHUNK_ITERATIONS = 4096;
+        static const GLuint STALL_CHUNK_GROUPS = 64;
+        static const int MAX_STALL_CHUNKS = 2000;
+
+        typedef struct owStallProgram {
+            GLint program;
+            GLint u_iterations;
+            GLuint sink;
+            // Times one chunk. Render context only.
+            GpuTimer timer;
+        } owStallProgram;
+
+        owStallProgram stallProgram;
+
+        // How the stereo warp reaches both eyes in one submission.
+        enum class StereoPath {
+            Multiview,  // GL_OVR_multiview2
+            Layered,    // instanced, gl_Layer from the vertex shader
+            PerEye,     // neither available: a draw per eye
+        };
+
+        typedef struct owStereoProgram {
+            StereoPath path;
+            GLint program;
+            GLuint vao;
+            GLint u_eye;
+            GLint u_renderInverseP;
+            GLint u_renderInverseV;
+            GLint u_bleedRadius;
+            GLint u_bleedTolerance;
+            GLint u_debugOpacity;
+
+            // One eye's reprojection mesh, half as wide as the mono one,
+            // so both eyes together cost the same. Owned by the mesh cache.
+            GLuint mesh_vertices_vbo;
+            GLuint mesh_indices_vbo;
+            GLsizei num_indices;
+
+            // Warped eyes, as layers. Presented side by side.
+            GLuint output_color;
+            GLuint output_depth;
+            GLuint fbo;
+            GLuint eye_fbo[NUM_EYES];
+        } owStereoProgram;
+
+        owStereoProgram stereoProgram;
+
+        // Resolution of the depth buffer copy the plane is fitted to.
+        static const GLuint PLANE_FIT_SIZE = 32;
+
+        typedef struct owPlaneFit {
+            // Downsampled depth. It is read back through the
+            // eye buffer's pixel buffer.
+            GLuint depth_texture;
+            GLuint fbo;
+
+            // Fitted plane, in the rendered camera's view space:
+            // normal.dot(x) == distance for points x on the plane.
+            Eigen::Vector3f normal = Eigen::Vector3f(0,0,-1);
+            float distance = 3.0f;
+            bool valid = false;
+        } owPlaneFit;
+
+        owPlaneFit planeFit;
+
         int initGL();
         int cleanupGL();
 
+        // Create the eye buffers, and the other objects that have to
+        // live on the render context. Called with it current.
+        void initRenderContext();
+
+        // Run fn on this thread with the render context current. Pauses
+        // the render thread around it, if it is running.
+        void runOnRenderContext(const std::function<void()>& fn);
+
+        void startRenderThread();
+        void joinRenderThread();
+        void renderLoop();
+
         void drawGUI();
         void processInput();
-        void renderScene();
-        void doReprojection(bool useRay);
+
+        // Frame number of the newest rendered eye buffer; 0 if none.
+        uint64_t newestFrameId();
+
+        // Create a timestamped dir for a test run under its output dir,
+        // recording the test origin in it.
+        std::string createRunDir(const TestRun& testRun);
+
+        // Switch the pose source, starting or stopping the synthetic
+        // tracker's thread. It moves around the current input pose.
+        void selectPoseProvider(bool synthetic);
+
+        // Render a frame at the current pose into a free eye buffer, and
+        // publish it to the warp. Returns its frame number, or 0 if none
+        // was rendered (dropped, or asked to stop). Render context only.
+        uint64_t renderEyeBuffer();
+        void renderScene(owEyeBuffer& eye);
+        void renderStereoScene(owEyeBuffer& eye);
+
+        // Keep the GPU busy for about ms. Render context only.
+        void burnGpuTime(double ms);
+
+        // Reserve an eye buffer for rendering into, waiting if the warp is
+        // still reading the only free one. Returns -1 if asked to stop.
+        int acquireRenderTarget();
+
+        // Newest Ready eye buffer, or -1. Needs eyeBufferMutex.
+        int newestEyeBuffer() const;
+
+        // Latch the newest eye buffer the GPU has finished rendering as the
+        // one to warp (or if there is none, the newest published one), and
+        // release it again once the warp has been issued. acquireWarpSource()
+        // returns false if nothing has been rendered yet. Given a frameId,
+        // it takes exactly that frame (false if it's not Ready), so that
+        // test runs are deterministic.
+        bool acquireWarpSource(uint64_t frameId = 0);
+        void releaseWarpSource();
+
+        // Show the newest eye buffer (or frameId's) as is, without reprojection.
+        void presentEyeBuffer(uint64_t frameId = 0);
+
+        // Show both layers of a stereo color array side by side.
+        void presentStereo(GLuint colorArray);
+
+        // (Re)create the linear depth texture, in the current precision.
+        void createLinearDepthTexture(owEyeBuffer& eye);
+        // Linearize the freshly rendered depth buffer.
+        void linearizeDepth(owEyeBuffer& eye);
+
+        // Build the min/max depth pyramid from the freshly linearized depth.
+        void buildHiZ(owEyeBuffer& eye);
+        void doReprojection(WarpAlgorithm algorithm, uint64_t frameId = 0);
+
+        // Mesh- or raymarch-based warp, against the full depth buffer.
+        void doDepthWarp(bool useRay, const Eigen::Matrix4f& freshCameraMatrix, GLuint framebuffer = 0, GLsizei width = 0);
+
+        // Raymarch warp as a tiled compute shader. With useTileList, only
+        // marches the tiles listed by the hybrid classifier, over whatever
+        // is already in its color target.
+        void doRayComputeWarp(const Eigen::Matrix4f& freshCameraMatrix, bool useTileList = false);
+
+        // Mesh warp, plus the compute raymarch on tiles near depth discontinuities.
+        void doHybridWarp(const Eigen::Matrix4f& freshCameraMatrix);
+
+        // Switch the warp settings to a governor quality level.
+        void applyQualityLevel(const QualityLevel& quality);
+
+        // Raymarch warp at reduced resolution, plus upsampling.
+        void doRayReducedWarp(const Eigen::Matrix4f& freshCameraMatrix);
+
+        // Look up / upload the uniforms shared by both raymarch programs.
+        void getRayUniforms(owRayProgram& ray);
+        void setRayUniforms(const owRayProgram& ray, const Eigen::Matrix4f& freshCameraMatrix);
+
+        // Kick off an asynchronous readback of the rendered depth, to fit the planar warp's plane to.
+        void requestPlaneFit(owEyeBuffer& eye);
+        // Fit the plane if the readback has landed. Never blocks.
+        void updatePlaneFit();
+
+        // Forward-splatting warp, with compute-shader scatter and hole filling.
+        void doSplatWarp();
+
+        // Warp the eye buffer with a single homography (see homographyMode),
+        // drawn as a full-screen triangle.
+        void doHomographyWarp();
+
+        // Mesh warp of both eyes of a stereo eye buffer, in one submission
+        // where the driver allows.
+        void doStereoWarp();
+
+        // Warp the newest eye buffer slice by slice, racing the beamRacer's
+        // virtual scanout. Mono only; the ray warp if that's the algorithm,
+        // otherwise the mesh warp.
+        void doBeamRacedWarp(WarpAlgorithm algorithm);
+
+        // The warp doBeamRacedWarp actually runs for algorithm.
+        const char* beamRacedWarpName(WarpAlgorithm algorithm) const {
+            return algorithm == WarpAlgorithm::Ray ? "full-resolution ray" : "mesh";
+        }
+
+        // Synthesize both eyes from a mono frame, with a mesh or ray warp
+        // per eye into the stereo output.
+        void doStereoFromMonoWarp(WarpAlgorithm algorithm, const Eigen::Matrix4f& freshCameraMatrix);
+
+        // Write everything the warp shaders need from the fresh pose
+        // into the current slot of the pose buffer.
+        void latchPose(const Eigen::Matrix4f& freshCameraMatrix, const Eigen::Matrix4f& warpProjection);
+
+        // Look up (or build and upload) the reprojection mesh of the given
+        // size, marking it as most recently used. Evicts the least
+        // recently used mesh if the cache is full.
+        const owMeshBuffers& acquireMesh(size_t width, size_t height);
 
         static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
             OpenwarpApplication::instance->renderFPS += yoffset;
@@ -235,9 +855,107 @@ class Openwarp::OpenwarpApplication{
                 if(OpenwarpApplication::instance != NULL &&
                     !OpenwarpApplication::instance->imgui_io.WantCaptureMouse) {
                     
-                    OpenwarpApplication::instance->useRay = !OpenwarpApplication::instance->useRay;
+                    auto instance = OpenwarpApplication::instance;
+                    instance->warpAlgorithm = NextWarpAlgorithm(instance->warpAlgorithm);
+                    instance->budgetFallbackActive = false;
                 }
             }
+
+            // Halve or double the reprojection mesh resolution.
+            if ((key == GLFW_KEY_LEFT_BRACKET || key == GLFW_KEY_RIGHT_BRACKET) && action == GLFW_PRESS) {
+                if(OpenwarpApplication::instance != NULL &&
+                    !OpenwarpApplication::instance->imgui_io.WantCaptureMouse) {
+
+                    auto instance = OpenwarpApplication::instance;
+                    instance->SetMeshSize(key == GLFW_KEY_LEFT_BRACKET ? instance->meshWidth / 2 : instance->meshWidth * 2);
+                }
+            }
+        }
+
+        // Homography taking homogeneous NDC of the fresh camera to homogeneous NDC
+        // of the rendered camera, for a pure rotation between the two. Ignores translation.
+        Eigen::Matrix3f rotationHomography(const Eigen::Matrix4f& freshCameraMatrix){
+            // The rows of the projection matrix that produce clip-space x, y and w.
+            Eigen::Matrix3f K;
+            K << projection(0,0), projection(0,1), projection(0,2),
+                 projection(1,0), projection(1,1), projection(1,2),
+                 projection(3,0), projection(3,1), projection(3,2);
+
+            Eigen::Matrix3f renderedRotation = renderedCameraMatrix.block<3,3>(0,0);
+            Eigen::Matrix3f freshRotation = freshCameraMatrix.block<3,3>(0,0);
+
+            return K * renderedRotation.transpose() * freshRotation * K.inverse();
+        }
+
+        // Homography taking homogeneous NDC of the fresh camera to homogeneous NDC
+        // of the rendered camera, exact for points on the given plane. The plane is
+        // in the rendered camera's view space, with normal.dot(x) == distance.
+        Eigen::Matrix3f planeHomography(const Eigen::Matrix4f& freshCameraMatrix, const Eigen::Vector3f& normal, float distance){
+            Eigen::Matrix3f K;
+            K << projection(0,0), projection(0,1), projection(0,2),
+                 projection(1,0), projection(1,1), projection(1,2),
+                 projection(3,0), projection(3,1), projection(3,2);
+
+            // Fresh view space to rendered view space is x_r = A * x_f + b.
+            Eigen::Matrix3f renderedRotation = renderedCameraMatrix.block<3,3>(0,0);
+            Eigen::Matrix3f A = renderedRotation.transpose() * freshCameraMatrix.block<3,3>(0,0);
+            Eigen::Vector3f b = renderedRotation.transpose() * (freshCameraMatrix.block<3,1>(0,3) - renderedCameraMatrix.block<3,1>(0,3));
+
+            // If the fresh eye has moved onto or through the plane, the
+            // plane can't be seen; the best we can do is rotation only.
+            float freshDistance = distance - normal.dot(b);
+            if(freshDistance <= 1e-4f) {
+                return K * A * K.inverse();
+            }
+
+            return K * (A + b * (normal.transpose() * A) / freshDistance) * K.inverse();
+        }
+
+        // Clip planes of the projection matrix built by perspective().
+        float projectionNear() const {
+            return projection(2,3) / (projection(2,2) - 1.0f);
+        }
+
+        float projectionFar() const {
+            return projection(2,3) / (projection(2,2) + 1.0f);
+        }
+
+        // Camera matrix for the pose at photonTime: interpolated from the
+        // active provider's history if it has samples that recent, or else
+        // predicted by the calling thread's predictor.
+        Eigen::Matrix4f predictedCameraMatrix(PosePredictor& predictor, double photonTime){
+            const PoseHistory& history = poseProvider.load()->History();
+            predictor.mode = predictionMode;
+            predictor.smoothing = predictionSmoothing;
+            predictor.Update(history);
+
+            PoseSample latest;
+            if(history.Latest(latest) && photonTime <= latest.time) {
+                PoseSample sample;
+                history.Sample(photonTime, sample);
+                return createCameraMatrix(sample.position, sample.orientation);
+            }
+            Eigen::Vector3f predictedPosition;
+            Eigen::Quaternionf predictedOrientation;
+            predictor.Predict(photonTime, predictedPosition, predictedOrientation);
+            return createCameraMatrix(predictedPosition, predictedOrientation);
+        }
+
+        // When the warp being issued now will reach the display: the next
+        // vsync when the warp is scheduled for it, or else as soon as it's done.
+        double warpPhotonTime(){
+            double now = glfwGetTime();
+            if(useVsync && useWarpScheduler) {
+                return vsyncScheduler.NextVsync(now);
+            }
+            return now + warpTimer.averageMs / 1000.0;
+        }
+
+        // Camera matrix of one eye (0 is left), given the head's.
+        Eigen::Matrix4f eyeCameraMatrix(const Eigen::Matrix4f& head, int eye, float eyeIpd) const {
+            Eigen::Matrix4f offset = Eigen::Matrix4f::Identity();
+            offset(0,3) = (eye == 0 ? -0.5f : 0.5f) * eyeIpd;
+            return head * offset;
         }
 
         Eigen::Matrix4f createCameraMatrix(Eigen::Vector3f position, Eigen::Quaternionf orientation){
@@ -305,62 +1023,6 @@ class Openwarp::OpenwarpApplication{
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
         }
 
-        // Build a rectangular plane.
-        void BuildMesh(size_t width, size_t height, std::vector<GLuint>& indices, std::vector<vertex_t>& vertices){
-            std::cout << "Generating reprojection mesh, size (" << width << ", " << height << ")" << std::endl;
-            // Compute the size of the vectors we'll need to store the
-            // data, ahead of time.
-
-            // width and height are not in # of verts, but in # of faces.
-            size_t num_indices = 2 * 3 * width * height;
-            size_t num_vertices = (width + 1)*(height + 1);
-
-            // Size the vectors accordingly
-            indices.resize(num_indices);
-            vertices.resize(num_vertices);
-
-            // Build indices.
-            for ( size_t y = 0; y < height; y++ ) {
-                for ( size_t x = 0; x < width; x++ ) {
-
-                    const int offset = ( y * width + x ) * 6;
-
-                    indices[offset + 0] = (GLuint)( ( y + 0 ) * ( width + 1 ) + ( x + 0 ) );
-                    indices[offset + 1] = (GLuint)( ( y + 1 ) * ( width + 1 ) + ( x + 0 ) );
-                    indices[offset + 2] = (GLuint)( ( y + 0 ) * ( width + 1 ) + ( x + 1 ) );
-
-                    indices[offset + 3] = (GLuint)( ( y + 0 ) * ( width + 1 ) + ( x + 1 ) );
-                    indices[offset + 4] = (GLuint)( ( y + 1 ) * ( width + 1 ) + ( x + 0 ) );
-                    indices[offset + 5] = (GLuint)( ( y + 1 ) * ( width + 1 ) + ( x + 1 ) );
-                }
-            }
-
-            // Build vertices
-            for (size_t y = 0; y < height + 1; y++){
-                for (size_t x = 0; x < width + 1; x++){
-
-                    size_t index = y * ( width + 1 ) + x;
-
-                    vertices[index].uv[0] = ((float)x / width);
-                    vertices[index].uv[1] = ((( height - (float)y) / height));
-
-                    if(x == 0) {
-                        vertices[index].uv[0] = -0.5f;
-                    }
-                    if(x == width) {
-                        vertices[index].uv[0] = 1.5f;
-                    }
-
-                    if(y == 0) {
-                        vertices[index].uv[1] = 1.5f;
-                    }
-                    if(y == height) {
-                        vertices[index].uv[1] = -0.5f;
-                    }
-                }
-            }
-        }
-
         // Perspective matrix construction borrowed from
         // http://spointeau.blogspot.com/2013/12/hello-i-am-looking-at-opengl-3.html
         // I would use GLM, but I'd like to use Eigen for the rest of my computations.
@@ -386,4 +1048,14 @@ class Openwarp::OpenwarpApplication{
             res(2,3) = - (2.0 * zFar * zNear) / (zFar - zNear);
             return res;
         }
+
+        // Off-axis perspective for one eye (0 is left) of a stereo pair. The
+        // frustum is shifted by asymmetry of its half-width towards the
+        // nose, so each eye sees further to its own side.
+        Eigen::Matrix4f eyePerspective(int eye, float fovy, float aspect, float zNear, float zFar, float asymmetry)
+        {
+            Eigen::Matrix4f res = perspective(fovy, aspect, zNear, zFar);
+            res(0,2) = (eye == 0 ? -asymmetry : asymmetry);
+            return res;
+        }
 };
\ No newline at end of file
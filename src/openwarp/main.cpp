@@ -10,25 +10,44 @@ int main(int argc, char *argv[]) {
     std::vector<std::string> args(argv + 1, argv + argc);
 
     std::string usageMessage =
-    "usage: ./openwarp [-h] [-mesh integer] [-disp displacement] [-step stepSize] [-output outputDir]\n\n"
+    "usage: ./openwarp [-h] [-mesh integer] [-meshcache cacheDir] [-disp displacement] [-step stepSize] [-output outputDir]\n"
+    "                  [-algo mesh|ray|planar|splat|hybrid] [-governorlog logFile]\n"
+    "                  [-stallprofile frameTimes] [-stereotest]\n\n"
     "Run the Openwarp demo application, with optional automation.\n\n"
     "optional arguments:\n"
     "  -h            Show this help message and exit\n"
     "  -mesh         Specify the width of the reprojection mesh for openwarp-mesh.\n"
     "                Defaults to 1024x1024.\n"
+    "  -meshcache    Cache built reprojection meshes in the given directory, and\n"
+    "                memory-map them on later runs instead of regenerating them.\n"
     "  -disp         Specify the max reprojection displacement of the automated test\n"
     "                run. If this is specified, you also need to specify -step.\n"
     "  -step         Specify the step size of the automated test run. If this is\n"
     "                specified, you also need to specify -disp.\n"
     "  -output       Specify the output directory for the automated test run. If\n"
-    "                this is specified, you also need to specify -disp and -step.\n";
+    "                this is specified, you also need to specify -disp and -step.\n"
+    "  -algo         Specify the reprojection algorithm used for the automated test\n"
+    "                run: mesh, ray, planar, splat or hybrid. Defaults to mesh.\n"
+    "  -governorlog  Start with the frame-budget governor enabled, and log each of\n"
+    "                its quality level changes to the given CSV file.\n"
+    "  -stallprofile Stall the rendered frames by frame times drawn from the given\n"
+    "                file (milliseconds, the first number on each line).\n"
+    "  -stereotest   Make the automated test run compare stereo synthesized from\n"
+    "                a mono frame (with the -algo warp, mesh or ray) against true\n"
+    "                stereo, reporting PSNR and scene GPU time for each pose.\n"
+    "                Needs -disp and -step.\n";
 
     bool doTestRun = false;
+    bool doStereoTest = false;
     float displacement = 0;
     float stepSize = 0;
     size_t meshSize = 1024;
     bool showGUI = true;
     std::string outputDir = "../output";
+    std::string meshCacheDir = "";
+    std::string governorLog = "";
+    std::string stallProfile = "";
+    WarpAlgorithm testAlgorithm = WarpAlgorithm::Mesh;
 
     for(size_t i = 0; i < args.size(); i++){
 
@@ -41,6 +60,14 @@ int main(int argc, char *argv[]) {
             showGUI = false;
         }
 
+        if(args[i].rfind("-meshcache", 0) == 0){
+            if(i == args.size() - 1) {
+                throw std::invalid_argument("Usage: -meshcache [mesh cache directory]");
+            }
+            meshCacheDir = args[i+1];
+            continue;
+        }
+
         if(args[i].rfind("-mesh") == 0){
             if(i == args.size() - 1) {
                 throw std::invalid_argument("Usage: -mesh [reprojection mesh dimension]");
@@ -86,17 +113,68 @@ int main(int argc, char *argv[]) {
             outputDir = args[i+1];
             doTestRun = true;
         }
+
+        if(args[i].rfind("-governorlog", 0) == 0){
+            if(i == args.size() - 1) {
+                throw std::invalid_argument("Usage: -governorlog [log file]");
+            }
+            governorLog = args[i+1];
+            continue;
+        }
+
+        if(args[i].rfind("-stallprofile", 0) == 0){
+            if(i == args.size() - 1) {
+                throw std::invalid_argument("Usage: -stallprofile [frame time file]");
+            }
+            stallProfile = args[i+1];
+            continue;
+        }
+
+        if(args[i].rfind("-stereotest", 0) == 0){
+            doStereoTest = true;
+            doTestRun = true;
+            continue;
+        }
+
+        if(args[i].rfind("-algo", 0) == 0){
+
+            if(i == args.size() - 1) {
+                throw std::invalid_argument("Usage: -algo [mesh|ray|planar|splat|hybrid]");
+            }
+
+            auto algorithm = ParseWarpAlgorithm(args[i+1]);
+            if(!algorithm){
+                throw std::invalid_argument("Usage: -algo must be followed by mesh, ray, planar, splat or hybrid.");
+            }
+            testAlgorithm = *algorithm;
+        }
     }
 
     if((displacement == 0 || stepSize == 0) && doTestRun)
         throw std::runtime_error("Usage: Neither stepSize nor displacement can be zero, if provided.");
 
-    OpenwarpApplication app = OpenwarpApplication(meshSize);
+    // Stereo from mono only has the mesh and ray warps.
+    if(doStereoTest && testAlgorithm != WarpAlgorithm::Mesh && testAlgorithm != WarpAlgorithm::Ray)
+        throw std::invalid_argument("Usage: -stereotest only supports -algo mesh or ray.");
+
+    OpenwarpApplication app = OpenwarpApplication(meshSize, meshCacheDir);
+
+    if(!governorLog.empty()) {
+        app.EnableGovernor(governorLog);
+    }
+
+    if(!stallProfile.empty() && !app.EnableStallProfile(stallProfile)) {
+        throw std::runtime_error("Could not load stall profile " + stallProfile);
+    }
 
     if(doTestRun) {
         TestRun test = TestRun(displacement, stepSize, outputDir);
         std::cout << "Running automated test. " << test.GetNumPoints() << " poses to run." << std::endl;
-        app.DoFullTestRun(test);
+        if(doStereoTest) {
+            app.DoStereoTestRun(test, testAlgorithm);
+        } else {
+            app.DoFullTestRun(test, testAlgorithm);
+        }
     } else {
         app.Run(showGUI);
     }
@@ -2,6 +2,7 @@
 #include <vector>
 #include <optional>
 #include <iostream>
+#include <string>
 #include <Eigen/Dense>
 
 #ifndef M_PI
@@ -17,4 +18,42 @@ namespace Openwarp{
         Eigen::Vector3f relative_pos;
         Eigen::Quaternionf orientation;
     } pose_t;
+
+    // Reprojection algorithms selectable at runtime.
+    enum class WarpAlgorithm {
+        Mesh,
+        Ray,
+        // Rotational timewarp, plus translation against a single plane.
+        Planar,
+        // Forward scatter of eye buffer texels, in a compute shader.
+        Splat,
+        // Mesh everywhere, plus raymarching on tiles near depth discontinuities.
+        Hybrid,
+        Count
+    };
+
+    inline const char* WarpAlgorithmName(WarpAlgorithm algorithm) {
+        switch(algorithm) {
+            case WarpAlgorithm::Mesh: return "Mesh-based";
+            case WarpAlgorithm::Ray: return "Raymarch-based";
+            case WarpAlgorithm::Planar: return "Planar (ATW)";
+            case WarpAlgorithm::Splat: return "Forward splat";
+            case WarpAlgorithm::Hybrid: return "Hybrid (mesh + ray)";
+            default: return "Unknown";
+        }
+    }
+
+    // Parses the short algorithm names used on the command line.
+    inline std::optional<WarpAlgorithm> ParseWarpAlgorithm(const std::string& name) {
+        if(name == "mesh") return WarpAlgorithm::Mesh;
+        if(name == "ray") return WarpAlgorithm::Ray;
+        if(name == "planar") return WarpAlgorithm::Planar;
+        if(name == "splat") return WarpAlgorithm::Splat;
+        if(name == "hybrid") return WarpAlgorithm::Hybrid;
+        return std::nullopt;
+    }
+
+    inline WarpAlgorithm NextWarpAlgorithm(WarpAlgorithm algorithm) {
+        return (WarpAlgorithm)(((int)algorithm + 1) % (int)WarpAlgorithm::Count);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "beam_racer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Openwarp;
+
+void BeamRacer::Reset(double refreshRate, double now) {
+	period = 1.0 / (refreshRate > 0 ? refreshRate : 60.0);
+	epoch = now;
+	frameScanout = now;
+	sliceCostMs = 0.0;
+	frameCostMs = 0.0;
+	resetStatistics();
+}
+
+void BeamRacer::SetNumSlices(int slices) {
+	numSlices = std::clamp(slices, 1, MAX_SLICES);
+	resetStatistics();
+}
+
+void BeamRacer::BeginFrame(double now) {
+	// Never the refresh already being scanned out, even if we're early.
+	double earliest = std::max(now + (sliceCostMs + safetyMarginMs) / 1000.0, frameScanout + period / 2);
+	double refreshes = std::ceil((earliest - epoch) / period);
+	frameScanout = epoch + refreshes * period;
+	frameCostMs = 0.0;
+	frames++;
+}
+
+double BeamRacer::ScanoutStart(int slice) const {
+	return frameScanout + period * slice / numSlices;
+}
+
+double BeamRacer::ScanoutMiddle(int slice) const {
+	return frameScanout + period * (slice + 0.5) / numSlices;
+}
+
+double BeamRacer::WarpStart(int slice) const {
+	return ScanoutStart(slice) - (sliceCostMs + safetyMarginMs) / 1000.0;
+}
+
+void BeamRacer::SliceDone(int slice, double poseTime, double issueTime, double doneTime) {
+	// React quickly to slices getting more expensive,
+	// and slowly to them getting cheaper.
+	double costMs = (doneTime - issueTime) * 1000.0;
+	sliceCostMs = (costMs > sliceCostMs) ? costMs : sliceCostMs * 0.95 + costMs * 0.05;
+	frameCostMs += costMs;
+
+	if(slice == 0) {
+		framePoseTime = poseTime;
+	}
+	if(doneTime > ScanoutStart(slice)) {
+		misses[slice]++;
+	}
+
+	double latency = (ScanoutMiddle(slice) - poseTime) * 1000.0;
+	double framePoseLatency = (ScanoutMiddle(slice) - framePoseTime) * 1000.0;
+	bool first = latencyMs[slice] == 0.0;
+	latencyMs[slice] = first ? latency : latencyMs[slice] * 0.95 + latency * 0.05;
+	framePoseLatencyMs[slice] = first ? framePoseLatency : framePoseLatencyMs[slice] * 0.95 + framePoseLatency * 0.05;
+}
+
+void BeamRacer::resetStatistics() {
+	for(int i = 0; i < MAX_SLICES; i++) {
+		latencyMs[i] = 0.0;
+		framePoseLatencyMs[i] = 0.0;
+		misses[i] = 0;
+	}
+	frames = 0;
+}
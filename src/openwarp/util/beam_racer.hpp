@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Openwarp {
+
+	// Times slice-by-slice warps against a virtual rolling display, for
+	// beam racing without the hardware: the display refreshes at a fixed
+	// rate from the time of Reset(), scanning rows out top to bottom over
+	// the whole refresh (there's no blanking interval).
+	//
+	// Each slice of the frame is warped just before scanout reaches it,
+	// from a pose sampled right then. The latency of a slice is from when
+	// its pose was sampled to when its middle row is scanned out; it's
+	// reported next to what it would have been had the whole frame been
+	// warped from the first slice's pose.
+	class BeamRacer {
+		public:
+		static const int MAX_SLICES = 16;
+
+		void Reset(double refreshRate, double now);
+
+		// Also forgets the statistics.
+		void SetNumSlices(int slices);
+		int NumSlices() const { return numSlices; }
+
+		// Aim the next frame at the first virtual refresh whose first
+		// slice can still be warped in time.
+		void BeginFrame(double now);
+
+		// When scanout reaches the first and middle rows of a slice
+		// (slice 0 at the top) of the current frame.
+		double ScanoutStart(int slice) const;
+		double ScanoutMiddle(int slice) const;
+
+		// When to start warping the slice, so that it's done
+		// safetyMarginMs before it's scanned out.
+		double WarpStart(int slice) const;
+
+		// The slice was warped from a pose sampled at poseTime; the warp
+		// was issued at issueTime, and the GPU finished it at doneTime.
+		void SliceDone(int slice, double poseTime, double issueTime, double doneTime);
+
+		double Period() const { return period; }
+		double SliceCostMs() const { return sliceCostMs; }
+
+		// Issue-to-completion time of all the current frame's slices so far.
+		double FrameCostMs() const { return frameCostMs; }
+		double LatencyMs(int slice) const { return latencyMs[slice]; }
+		double FramePoseLatencyMs(int slice) const { return framePoseLatencyMs[slice]; }
+		uint64_t Misses(int slice) const { return misses[slice]; }
+		uint64_t Frames() const { return frames; }
+
+		float safetyMarginMs = 0.5f;
+
+		private:
+		void resetStatistics();
+
+		double period = 1.0 / 60.0;
+		double epoch = 0.0;
+		double frameScanout = 0.0;
+		double framePoseTime = 0.0;
+		int numSlices = 4;
+
+		double sliceCostMs = 0.0;
+		double frameCostMs = 0.0;
+		double latencyMs[MAX_SLICES] = {};
+		double framePoseLatencyMs[MAX_SLICES] = {};
+		uint64_t misses[MAX_SLICES] = {};
+		uint64_t frames = 0;
+	};
+}
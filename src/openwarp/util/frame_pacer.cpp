@@ -0,0 +1,96 @@
+#include "frame_pacer.hpp"
+#include "timing.hpp"
+
+#include <GLFW/glfw3.h>
+
+using namespace Openwarp;
+
+namespace {
+
+	const double WINDOW_SECONDS = 0.5;
+
+	// OS sleeps are accurate to well under this, so only the very end
+	// of the wait spins. It counts as asleep, which flatters the paced
+	// modes by at most this much per frame.
+	const double SPIN_MARGIN = 0.0005;
+}
+
+void FramePacer::Reset(double rateHz) {
+	period = 1.0 / (rateHz > 0 ? rateHz : 60.0);
+	nextFrame = 0.0;
+	hasWarp = false;
+	cpuUtilisation = 0.0;
+	gpuUtilisation = 0.0;
+	spinCpuUtilisation = 0.0;
+	spinGpuUtilisation = 0.0;
+	frames = 0;
+	skipped = 0;
+	restartWindow(glfwGetTime());
+}
+
+void FramePacer::SetMode(PacingMode newMode) {
+	if(newMode == mode) {
+		return;
+	}
+	mode = newMode;
+	nextFrame = 0.0;
+	hasWarp = false;
+	restartWindow(glfwGetTime());
+}
+
+void FramePacer::WaitForFrame() {
+	double now = glfwGetTime();
+	nextFrame += period;
+	if(nextFrame < now) {
+		nextFrame = now;
+		return;
+	}
+	PreciseSleepUntil(nextFrame, SPIN_MARGIN);
+	windowSleep += glfwGetTime() - now;
+}
+
+bool FramePacer::NeedsWarp(const PoseSample& pose, uint64_t frameId, double now) const {
+	if(!hasWarp || frameId != warpedFrameId || now - warpTime >= refreshSeconds) {
+		return true;
+	}
+	if((pose.position - warpedPose.position).norm() > positionEpsilon) {
+		return true;
+	}
+	return pose.orientation.angularDistance(warpedPose.orientation) > rotationEpsilon;
+}
+
+void FramePacer::FrameWarped(const PoseSample& pose, uint64_t frameId, double now, double warpGpuMs) {
+	hasWarp = true;
+	warpedPose = pose;
+	warpedFrameId = frameId;
+	warpTime = now;
+	frameDone(now, warpGpuMs);
+}
+
+void FramePacer::FrameSkipped(double now) {
+	skipped++;
+	frameDone(now, 0.0);
+}
+
+void FramePacer::frameDone(double now, double warpGpuMs) {
+	frames++;
+	windowGpuMs += warpGpuMs;
+
+	double elapsed = now - windowStart;
+	if(elapsed < WINDOW_SECONDS) {
+		return;
+	}
+	cpuUtilisation = 1.0 - windowSleep / elapsed;
+	gpuUtilisation = windowGpuMs / (1000.0 * elapsed);
+	if(mode == PacingMode::Spin) {
+		spinCpuUtilisation = cpuUtilisation;
+		spinGpuUtilisation = gpuUtilisation;
+	}
+	restartWindow(now);
+}
+
+void FramePacer::restartWindow(double now) {
+	windowStart = now;
+	windowSleep = 0.0;
+	windowGpuMs = 0.0;
+}
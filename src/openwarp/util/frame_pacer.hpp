@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <cstdint>
+
+#include "pose_provider.hpp"
+
+namespace Openwarp {
+
+	enum class PacingMode {
+		Spin,           // start each frame as soon as the last is done
+		DisplayRate,    // a frame per display refresh, sleeping in between
+		SkipUnchanged,  // as DisplayRate, but re-present the last warp if nothing changed
+	};
+
+	// Paces the main loop when vsync isn't, and measures what that saves:
+	// the share of wall-clock time the main thread is busy rather than
+	// asleep in WaitForFrame(), and the share the GPU spends warping.
+	// Utilisation is measured over windows of half a second; the last
+	// one measured while spinning is kept as the baseline to compare to.
+	class FramePacer {
+		public:
+		void Reset(double rateHz);
+
+		// Switching mode restarts the measurement, and forgets the last warp.
+		void SetMode(PacingMode mode);
+		PacingMode Mode() const { return mode; }
+
+		// Sleep until the next frame is due, at rateHz. Oversleeping only
+		// delays that frame; a frame that falls a whole period behind
+		// doesn't make the next ones hurry to catch up.
+		void WaitForFrame();
+
+		// Whether the last warp is out of date: the pose has moved, the
+		// eye buffer is newer, or it is older than refreshSeconds (so
+		// settings changed without moving still show up).
+		bool NeedsWarp(const PoseSample& pose, uint64_t frameId, double now) const;
+
+		// A frame was presented; if warped, from this pose and eye buffer,
+		// at this GPU cost. Otherwise the last warp was re-presented.
+		void FrameWarped(const PoseSample& pose, uint64_t frameId, double now, double warpGpuMs);
+		void FrameSkipped(double now);
+
+		double RateHz() const { return 1.0 / period; }
+		double CpuUtilisation() const { return cpuUtilisation; }
+		double GpuUtilisation() const { return gpuUtilisation; }
+		double SpinCpuUtilisation() const { return spinCpuUtilisation; }
+		double SpinGpuUtilisation() const { return spinGpuUtilisation; }
+		uint64_t Frames() const { return frames; }
+		uint64_t Skipped() const { return skipped; }
+
+		// Movement below these counts as none.
+		float positionEpsilon = 0.0001f;    // metres
+		float rotationEpsilon = 0.0002f;    // radians
+		double refreshSeconds = 0.25;
+
+		private:
+		void frameDone(double now, double warpGpuMs);
+		void restartWindow(double now);
+
+		PacingMode mode = PacingMode::Spin;
+		double period = 1.0 / 60.0;
+		double nextFrame = 0.0;
+
+		bool hasWarp = false;
+		PoseSample warpedPose;
+		uint64_t warpedFrameId = 0;
+		double warpTime = 0.0;
+
+		double windowStart = 0.0;
+		double windowSleep = 0.0;
+		double windowGpuMs = 0.0;
+
+		double cpuUtilisation = 0.0;
+		double gpuUtilisation = 0.0;
+		double spinCpuUtilisation = 0.0;
+		double spinGpuUtilisation = 0.0;
+		uint64_t frames = 0;
+		uint64_t skipped = 0;
+	};
+}
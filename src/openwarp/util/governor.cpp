@@ -0,0 +1,68 @@
+#include "governor.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace Openwarp;
+
+WarpGovernor::WarpGovernor() {
+	ladder = {
+		{ "Raymarch, full resolution",   WarpAlgorithm::Ray,    1024, 32, 1 },
+		{ "Hybrid, 1024 mesh",           WarpAlgorithm::Hybrid, 1024, 32, 1 },
+		{ "Hybrid, 512 mesh",            WarpAlgorithm::Hybrid,  512, 16, 1 },
+		{ "Mesh, 1024",                  WarpAlgorithm::Mesh,   1024, 16, 1 },
+		{ "Mesh, 512",                   WarpAlgorithm::Mesh,    512, 16, 1 },
+		{ "Mesh, 256",                   WarpAlgorithm::Mesh,    256, 16, 1 },
+		{ "Planar (ATW)",                WarpAlgorithm::Planar,  256, 16, 1 },
+	};
+}
+
+bool WarpGovernor::OpenLog(const std::string& path) {
+	log.open(path, std::ios::trunc);
+	if(!log) {
+		return false;
+	}
+	log << "time_s,frame,warp_ms,budget_ms,from_level,to_level,reason,level_name" << std::endl;
+	return true;
+}
+
+bool WarpGovernor::Update(double timeSeconds, double warpMs) {
+	frame++;
+
+	if(cooldown > 0) {
+		cooldown--;
+		return false;
+	}
+
+	overCount = (warpMs > highWater * budgetMs) ? overCount + 1 : 0;
+	underCount = (warpMs < lowWater * budgetMs) ? underCount + 1 : 0;
+
+	if(overCount >= downFrames && level + 1 < ladder.size()) {
+		change(timeSeconds, warpMs, level + 1, "over_budget");
+		return true;
+	}
+	if(underCount >= upFrames && level > 0) {
+		change(timeSeconds, warpMs, level - 1, "under_budget");
+		return true;
+	}
+	return false;
+}
+
+void WarpGovernor::SetLevel(size_t newLevel) {
+	level = std::min(newLevel, ladder.size() - 1);
+	overCount = 0;
+	underCount = 0;
+	cooldown = cooldownFrames;
+}
+
+void WarpGovernor::change(double timeSeconds, double warpMs, size_t newLevel, const char* reason) {
+	std::cout << "Governor: warp took " << warpMs << " ms (budget " << budgetMs << " ms); "
+			  << ladder[level].name << " -> " << ladder[newLevel].name << std::endl;
+
+	if(log) {
+		log << timeSeconds << "," << frame << "," << warpMs << "," << budgetMs << ","
+			<< level << "," << newLevel << "," << reason << "," << ladder[newLevel].name << std::endl;
+	}
+
+	SetLevel(newLevel);
+}
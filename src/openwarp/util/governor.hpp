@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../openwarp.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Openwarp {
+
+	// One rung of the governor's quality ladder.
+	struct QualityLevel {
+		const char* name;
+		WarpAlgorithm algorithm;
+		size_t meshSize;
+		int rayMaxIterations;
+		int rayResolutionDivisor;
+	};
+
+	// Keeps the warp pass under its GPU budget by stepping down (or back up)
+	// a ladder of quality levels, ordered from best to cheapest.
+	//
+	// Hysteresis: it only steps down after warp time has been over
+	// highWater * budget for downFrames warps in a row, and only steps
+	// back up after upFrames warps in a row under lowWater * budget.
+	// After any change it waits cooldownFrames warps, since GPU timings
+	// arrive a few frames late and would still reflect the old level.
+	class WarpGovernor {
+		public:
+		WarpGovernor();
+
+		// Log every decision to a CSV file. Returns false if it can't be opened.
+		bool OpenLog(const std::string& path);
+
+		// Feed the GPU time of one warp. Returns true if the level changed,
+		// in which case Current() should be applied.
+		bool Update(double timeSeconds, double warpMs);
+
+		// Jump straight to a level (e.g. when re-enabled), resetting the hysteresis.
+		void SetLevel(size_t level);
+
+		size_t Level() const { return level; }
+		size_t NumLevels() const { return ladder.size(); }
+		const QualityLevel& Current() const { return ladder[level]; }
+
+		float budgetMs = 4.0f;
+		float highWater = 0.9f;
+		float lowWater = 0.6f;
+		int downFrames = 3;
+		int upFrames = 120;
+		int cooldownFrames = 30;
+
+		private:
+		void change(double timeSeconds, double warpMs, size_t newLevel, const char* reason);
+
+		std::vector<QualityLevel> ladder;
+		size_t level = 0;
+		int overCount = 0;
+		int underCount = 0;
+		int cooldown = 0;
+		uint64_t frame = 0;
+
+		std::ofstream log;
+	};
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+
+namespace Openwarp {
+
+	// Non-blocking GPU timer built on GL_TIME_ELAPSED queries.
+	// Queries are kept in a small ring and read back a few frames
+	// late, so timing a pass never stalls the pipeline.
+	//
+	// GL_TIME_ELAPSED queries cannot be nested; only one timer
+	// may be between Begin() and End() at any given time.
+	struct GpuTimer {
+		static const size_t NUM_QUERIES = 4;
+
+		GLuint queries[NUM_QUERIES];
+		bool pending[NUM_QUERIES] = {};
+		size_t current = 0;
+
+		// Most recent result, and an exponential moving average.
+		double lastMs = 0.0;
+		double averageMs = 0.0;
+
+		// Results read back so far; when it changes, lastMs is new.
+		uint64_t results = 0;
+
+		void Init() {
+			glGenQueries(NUM_QUERIES, queries);
+		}
+
+		void Cleanup() {
+			glDeleteQueries(NUM_QUERIES, queries);
+		}
+
+		void Begin() {
+			Collect();
+
+			// Only block if the ring has wrapped around onto
+			// a query the GPU still hasn't finished.
+			if(pending[current]) {
+				read(current);
+			}
+			glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+		}
+
+		void End() {
+			glEndQuery(GL_TIME_ELAPSED);
+			pending[current] = true;
+			current = (current + 1) % NUM_QUERIES;
+		}
+
+		// Read back any finished queries without blocking.
+		void Collect() {
+			for(size_t i = 0; i < NUM_QUERIES; i++) {
+				size_t q = (current + i) % NUM_QUERIES;
+				if(!pending[q]) {
+					continue;
+				}
+				GLint available = 0;
+				glGetQueryObjectiv(queries[q], GL_QUERY_RESULT_AVAILABLE, &available);
+				if(!available) {
+					break;
+				}
+				read(q);
+			}
+		}
+
+		// Block until every outstanding query has been read back, so
+		// lastMs is the latest pass. For measurements, not per frame.
+		void Finish() {
+			for(size_t i = 0; i < NUM_QUERIES; i++) {
+				size_t q = (current + i) % NUM_QUERIES;
+				if(pending[q]) {
+					read(q);
+				}
+			}
+		}
+
+		private:
+		void read(size_t q) {
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(queries[q], GL_QUERY_RESULT, &elapsed);
+			pending[q] = false;
+			results++;
+			lastMs = elapsed / 1000000.0;
+			averageMs = (averageMs == 0.0) ? lastMs : averageMs * 0.9 + lastMs * 0.1;
+		}
+	};
+}
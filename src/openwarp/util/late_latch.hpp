@@ -0,0 +1,84 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstring>
+
+namespace Openwarp {
+
+	// Fresh-pose data read by the warp shaders, laid out to match the
+	// std140 WarpPose block in openwarp_pose.glsl.
+	struct WarpPose {
+		GLfloat warpVP[16];
+		GLfloat warpInverseVP[16];
+		GLfloat warpPos[4];        // vec3, padded
+		GLfloat homography[12];    // mat3, as three padded columns
+		GLfloat eyeWarpVP[2][16];  // per eye, for the stereo warp
+	};
+
+	// Persistently mapped uniform buffer holding the warp's fresh pose,
+	// for late latching: the pose can be rewritten after the warp's
+	// commands have been issued, up until they are flushed, and the GPU
+	// picks up whatever is there when it actually runs the warp.
+	//
+	// Each warp gets its own slot in a small ring, so rewriting the pose
+	// never changes it under a warp the GPU is still running.
+	struct LateLatchBuffer {
+		static const size_t NUM_SLOTS = 3;
+
+		GLuint buffer = 0;
+		char* mapped = nullptr;
+		GLsizeiptr slotSize = 0;
+		GLsync fences[NUM_SLOTS] = {};
+		size_t current = 0;
+
+		void Init() {
+			// Slots have to start on a uniform buffer offset boundary.
+			GLint alignment = 256;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			slotSize = ((sizeof(WarpPose) + alignment - 1) / alignment) * alignment;
+
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+			glBufferStorage(GL_UNIFORM_BUFFER, slotSize * NUM_SLOTS, nullptr, flags);
+			mapped = (char*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, slotSize * NUM_SLOTS, flags);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		}
+
+		void Cleanup() {
+			for(GLsync& fence : fences) {
+				if(fence) {
+					glDeleteSync(fence);
+					fence = 0;
+				}
+			}
+			glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+			glUnmapBuffer(GL_UNIFORM_BUFFER);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			glDeleteBuffers(1, &buffer);
+		}
+
+		// Move on to the next slot, and bind it for the warp about to be
+		// issued. Only blocks if the GPU is NUM_SLOTS warps behind.
+		void Begin(GLuint binding) {
+			current = (current + 1) % NUM_SLOTS;
+			if(fences[current]) {
+				glClientWaitSync(fences[current], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+				glDeleteSync(fences[current]);
+				fences[current] = 0;
+			}
+			glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, current * slotSize, sizeof(WarpPose));
+		}
+
+		// Write the pose for the current warp. Can be called any number
+		// of times between Begin() and End(); the last write wins.
+		void Latch(const WarpPose& pose) {
+			std::memcpy(mapped + current * slotSize, &pose, sizeof(WarpPose));
+		}
+
+		// Call after the last Latch(), before the warp is flushed.
+		void End() {
+			fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+	};
+}
@@ -0,0 +1,236 @@
+#include "mesh.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Openwarp;
+
+namespace {
+
+	// Meshes smaller than this many rows aren't worth spinning up threads for.
+	const size_t MIN_ROWS_PER_THREAD = 64;
+
+	// Header at the start of every mesh cache file.
+	struct mesh_cache_header_t {
+		char magic[4];
+		uint32_t layout;
+		uint32_t vertex_size;
+		uint64_t width;
+		uint64_t height;
+		uint64_t num_vertices;
+		uint64_t num_indices;
+	};
+
+	const char MESH_CACHE_MAGIC[4] = { 'O', 'W', 'M', 'S' };
+
+	std::string cachePath(std::string cache_dir, size_t width, size_t height) {
+		if(cache_dir.back() != '/') {
+			cache_dir += '/';
+		}
+		return cache_dir + "mesh_" + std::to_string(width) + "x" + std::to_string(height)
+			   + "_v" + std::to_string(MESH_LAYOUT_VERSION) + ".bin";
+	}
+
+	// Run fn(begin, end) over [0, count), split into contiguous
+	// chunks across the available hardware threads.
+	template<typename Fn>
+	void parallelRows(size_t count, Fn fn) {
+		size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+		num_threads = std::min(num_threads, std::max<size_t>(1, count / MIN_ROWS_PER_THREAD));
+
+		if(num_threads == 1) {
+			fn(0, count);
+			return;
+		}
+
+		std::vector<std::thread> workers;
+		size_t chunk = (count + num_threads - 1) / num_threads;
+		for(size_t begin = 0; begin < count; begin += chunk) {
+			workers.emplace_back(fn, begin, std::min(begin + chunk, count));
+		}
+		for(auto& worker : workers) {
+			worker.join();
+		}
+	}
+}
+
+void Openwarp::BuildMesh(size_t width, size_t height, std::vector<GLuint>& indices, std::vector<vertex_t>& vertices) {
+	// Compute the size of the vectors we'll need to store the
+	// data, ahead of time.
+	size_t num_indices = 2 * 3 * width * height;
+	size_t num_vertices = (width + 1)*(height + 1);
+
+	// Size the vectors accordingly
+	indices.resize(num_indices);
+	vertices.resize(num_vertices);
+
+	GLuint* const index_data = indices.data();
+	vertex_t* const vertex_data = vertices.data();
+
+	// Build indices. The inner loops are branch-free and only
+	// depend on x, so the compiler can vectorize them.
+	parallelRows(height, [=](size_t y_begin, size_t y_end) {
+		for ( size_t y = y_begin; y < y_end; y++ ) {
+			GLuint* row = index_data + y * width * 6;
+			const GLuint top = (GLuint)( y * ( width + 1 ) );
+			const GLuint bottom = (GLuint)( ( y + 1 ) * ( width + 1 ) );
+
+			for ( size_t x = 0; x < width; x++ ) {
+				const GLuint col = (GLuint)x;
+				row[x * 6 + 0] = top + col;
+				row[x * 6 + 1] = bottom + col;
+				row[x * 6 + 2] = top + col + 1;
+
+				row[x * 6 + 3] = top + col + 1;
+				row[x * 6 + 4] = bottom + col;
+				row[x * 6 + 5] = bottom + col + 1;
+			}
+		}
+	});
+
+	// Build vertices. The outermost ring of vertices is pushed out past
+	// the edges of the eye buffer; we patch those up after the inner
+	// loops rather than branching per-vertex.
+	const float fwidth = (float)width;
+	const float fheight = (float)height;
+	parallelRows(height + 1, [=](size_t y_begin, size_t y_end) {
+		for ( size_t y = y_begin; y < y_end; y++ ) {
+			vertex_t* row = vertex_data + y * ( width + 1 );
+
+			float v = ( fheight - (float)y ) / fheight;
+			if(y == 0) {
+				v = 1.5f;
+			}
+			if(y == height) {
+				v = -0.5f;
+			}
+
+			for ( size_t x = 0; x < width + 1; x++ ) {
+				row[x].uv[0] = (float)x / fwidth;
+				row[x].uv[1] = v;
+			}
+
+			row[0].uv[0] = -0.5f;
+			row[width].uv[0] = 1.5f;
+		}
+	});
+}
+
+MappedMesh::~MappedMesh() {
+#ifndef _WIN32
+	if(mapping != nullptr) {
+		munmap(mapping, mapping_size);
+	}
+#endif
+}
+
+bool MappedMesh::Load(const std::string& cache_dir, size_t width, size_t height) {
+	std::string path = cachePath(cache_dir, width, height);
+	const char* data = nullptr;
+	size_t size = 0;
+
+#ifndef _WIN32
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+	struct stat file_stat;
+	if(fstat(fd, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(mesh_cache_header_t)) {
+		close(fd);
+		return false;
+	}
+	size = file_stat.st_size;
+	void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) {
+		return false;
+	}
+	mapping = map;
+	mapping_size = size;
+	data = (const char*)map;
+#else
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file) {
+		return false;
+	}
+	size = file.tellg();
+	if(size < sizeof(mesh_cache_header_t)) {
+		return false;
+	}
+	buffer.resize(size);
+	file.seekg(0);
+	file.read(buffer.data(), size);
+	data = buffer.data();
+#endif
+
+	mesh_cache_header_t header;
+	std::memcpy(&header, data, sizeof(header));
+
+	size_t expected_size = sizeof(header) + header.num_vertices * sizeof(vertex_t) + header.num_indices * sizeof(GLuint);
+	if(std::memcmp(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 ||
+	   header.layout != MESH_LAYOUT_VERSION ||
+	   header.vertex_size != sizeof(vertex_t) ||
+	   header.width != width || header.height != height ||
+	   header.num_vertices != (width + 1) * (height + 1) ||
+	   header.num_indices != 6 * width * height ||
+	   size != expected_size) {
+		return false;
+	}
+
+	vertices = (const vertex_t*)(data + sizeof(header));
+	num_vertices = header.num_vertices;
+	indices = (const GLuint*)(data + sizeof(header) + num_vertices * sizeof(vertex_t));
+	num_indices = header.num_indices;
+
+	return true;
+}
+
+bool Openwarp::StoreCachedMesh(const std::string& cache_dir, size_t width, size_t height,
+							   const std::vector<GLuint>& indices, const std::vector<vertex_t>& vertices) {
+	std::error_code err;
+	fs::create_directories(cache_dir, err);
+	if(err) {
+		return false;
+	}
+
+	mesh_cache_header_t header;
+	std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+	header.layout = MESH_LAYOUT_VERSION;
+	header.vertex_size = sizeof(vertex_t);
+	header.width = width;
+	header.height = height;
+	header.num_vertices = vertices.size();
+	header.num_indices = indices.size();
+
+	// Write to a temporary file and rename, so that a concurrent
+	// reader never maps a half-written cache entry.
+	std::string path = cachePath(cache_dir, width, height);
+	std::string tmp_path = path + ".tmp";
+	std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+	if(!file) {
+		return false;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)vertices.data(), vertices.size() * sizeof(vertex_t));
+	file.write((const char*)indices.data(), indices.size() * sizeof(GLuint));
+	file.close();
+	if(!file) {
+		fs::remove(tmp_path, err);
+		return false;
+	}
+
+	fs::rename(tmp_path, path, err);
+	return !err;
+}
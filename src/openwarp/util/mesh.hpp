@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../openwarp.hpp"
+#include "obj.hpp"
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+namespace Openwarp {
+
+	// Bump this whenever BuildMesh changes the geometry it produces,
+	// so that stale on-disk mesh caches are not picked up.
+	const uint32_t MESH_LAYOUT_VERSION = 1;
+
+	// Build a rectangular plane.
+	// width and height are not in # of verts, but in # of faces.
+	// Rows are split across all available hardware threads.
+	void BuildMesh(size_t width, size_t height, std::vector<GLuint>& indices, std::vector<vertex_t>& vertices);
+
+	// Read-only reprojection mesh geometry loaded from the on-disk
+	// mesh cache. Where possible the file is memory-mapped, and the
+	// vertex/index pointers point directly into the mapping, so it can
+	// be handed straight to glBufferData without another copy.
+	class MappedMesh {
+		public:
+		MappedMesh() = default;
+		~MappedMesh();
+
+		MappedMesh(const MappedMesh&) = delete;
+		MappedMesh& operator=(const MappedMesh&) = delete;
+
+		// Map the cached mesh of the given size from cache_dir.
+		// Returns false if there is no valid cache entry.
+		bool Load(const std::string& cache_dir, size_t width, size_t height);
+
+		const vertex_t* vertices = nullptr;
+		size_t num_vertices = 0;
+		const GLuint* indices = nullptr;
+		size_t num_indices = 0;
+
+		private:
+		void* mapping = nullptr;
+		size_t mapping_size = 0;
+
+		// Fallback storage on platforms without mmap.
+		std::vector<char> buffer;
+	};
+
+	// Write a built mesh to cache_dir, keyed by (width, height, layout).
+	// Returns false if the cache file could not be written.
+	bool StoreCachedMesh(const std::string& cache_dir, size_t width, size_t height,
+						 const std::vector<GLuint>& indices, const std::vector<vertex_t>& vertices);
+}
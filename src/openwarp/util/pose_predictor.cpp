@@ -0,0 +1,108 @@
+#include "pose_predictor.hpp"
+
+#include <algorithm>
+
+using namespace Openwarp;
+
+namespace {
+
+	// Samples closer together than this are too noisy to differentiate.
+	const double MIN_SAMPLE_INTERVAL = 1e-4;
+
+	// Rotation vector (axis * angle) of a unit quaternion.
+	Eigen::Vector3f rotationVector(const Eigen::Quaternionf& q) {
+		Eigen::AngleAxisf angleAxis(q.w() < 0 ? Eigen::Quaternionf(-q.coeffs()) : q);
+		return angleAxis.axis() * angleAxis.angle();
+	}
+
+	Eigen::Quaternionf fromRotationVector(const Eigen::Vector3f& v) {
+		float angle = v.norm();
+		if(angle < 1e-8f) {
+			return Eigen::Quaternionf::Identity();
+		}
+		return Eigen::Quaternionf(Eigen::AngleAxisf(angle, v / angle));
+	}
+}
+
+void PosePredictor::Reset() {
+	source = nullptr;
+	numSamples = 0;
+	velocity.setZero();
+	acceleration.setZero();
+	angularVelocity.setZero();
+	angularAcceleration.setZero();
+}
+
+void PosePredictor::AddSample(double time, const Eigen::Vector3f& position, const Eigen::Quaternionf& orientation) {
+	double dt = time - lastTime;
+	if(numSamples > 0 && dt < MIN_SAMPLE_INTERVAL) {
+		return;
+	}
+
+	if(numSamples > 0) {
+		float invDt = (float)(1.0 / dt);
+		float keep = std::clamp(smoothing, 0.0f, 0.99f);
+
+		Eigen::Vector3f newVelocity = (position - lastPosition) * invDt;
+		Eigen::Vector3f newAngularVelocity = rotationVector(orientation * lastOrientation.inverse()) * invDt;
+		if(numSamples > 1) {
+			newVelocity = keep * velocity + (1.0f - keep) * newVelocity;
+			newAngularVelocity = keep * angularVelocity + (1.0f - keep) * newAngularVelocity;
+
+			Eigen::Vector3f newAcceleration = (newVelocity - velocity) * invDt;
+			Eigen::Vector3f newAngularAcceleration = (newAngularVelocity - angularVelocity) * invDt;
+			if(numSamples > 2) {
+				newAcceleration = keep * acceleration + (1.0f - keep) * newAcceleration;
+				newAngularAcceleration = keep * angularAcceleration + (1.0f - keep) * newAngularAcceleration;
+			}
+			acceleration = newAcceleration;
+			angularAcceleration = newAngularAcceleration;
+		}
+		velocity = newVelocity;
+		angularVelocity = newAngularVelocity;
+	}
+
+	lastTime = time;
+	lastPosition = position;
+	lastOrientation = orientation;
+	numSamples++;
+}
+
+void PosePredictor::Update(const PoseHistory& history) {
+	if(&history != source) {
+		Reset();
+		source = &history;
+	}
+
+	PoseSample samples[MAX_UPDATE_SAMPLES];
+	size_t count = history.SamplesAfter(numSamples > 0 ? lastTime : -1.0, samples, MAX_UPDATE_SAMPLES);
+	for(size_t i = 0; i < count; i++) {
+		AddSample(samples[i].time, samples[i].position, samples[i].orientation);
+	}
+}
+
+void PosePredictor::Predict(double time, Eigen::Vector3f& position, Eigen::Quaternionf& orientation) const {
+	if(numSamples == 0) {
+		position.setZero();
+		orientation.setIdentity();
+		return;
+	}
+
+	position = lastPosition;
+	orientation = lastOrientation;
+	if(mode == PredictionMode::None) {
+		return;
+	}
+
+	float h = (float)std::clamp(time - lastTime, 0.0, (double)maxPredictionSeconds);
+
+	Eigen::Vector3f linear = velocity * h;
+	Eigen::Vector3f angular = angularVelocity * h;
+	if(mode == PredictionMode::ConstantAcceleration) {
+		linear += 0.5f * acceleration * h * h;
+		angular += 0.5f * angularAcceleration * h * h;
+	}
+
+	position += linear;
+	orientation = (fromRotationVector(angular) * lastOrientation).normalized();
+}
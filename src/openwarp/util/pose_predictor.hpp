@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include "pose_provider.hpp"
+
+namespace Openwarp {
+
+	enum class PredictionMode {
+		None,
+		ConstantVelocity,
+		ConstantAcceleration,
+	};
+
+	// Extrapolates the head pose to the time its photons will reach the
+	// display. Velocities (linear and angular) are finite differences of
+	// consecutive samples, and accelerations differences of those, each
+	// smoothed with an exponential filter so noisy input doesn't turn
+	// into jittery predictions.
+	class PosePredictor {
+		public:
+		void Reset();
+
+		// Feed the pose sampled at time (in seconds, glfwGetTime()).
+		void AddSample(double time, const Eigen::Vector3f& position, const Eigen::Quaternionf& orientation);
+
+		// Feed every sample pushed to history since the last Update(). A
+		// different history than last time starts the predictor afresh.
+		// Each consumer thread should use a PosePredictor of its own.
+		void Update(const PoseHistory& history);
+
+		// Pose at the given time, extrapolated from the last sample by
+		// at most maxPredictionSeconds. Just the last sample with
+		// PredictionMode::None; identity if there are no samples.
+		void Predict(double time, Eigen::Vector3f& position, Eigen::Quaternionf& orientation) const;
+
+		bool HasSamples() const { return numSamples > 0; }
+
+		PredictionMode mode = PredictionMode::ConstantVelocity;
+
+		// 0 uses the raw finite differences; towards 1, filters harder
+		// (and lags more).
+		float smoothing = 0.6f;
+
+		// Never extrapolate further than this.
+		float maxPredictionSeconds = 0.1f;
+
+		private:
+		// Most samples taken from the history per Update().
+		static const size_t MAX_UPDATE_SAMPLES = 64;
+
+		const PoseHistory* source = nullptr;
+		int numSamples = 0;
+		double lastTime = 0.0;
+		Eigen::Vector3f lastPosition = Eigen::Vector3f::Zero();
+		Eigen::Quaternionf lastOrientation = Eigen::Quaternionf::Identity();
+
+		// World space; angular velocity as axis * radians per second.
+		Eigen::Vector3f velocity = Eigen::Vector3f::Zero();
+		Eigen::Vector3f acceleration = Eigen::Vector3f::Zero();
+		Eigen::Vector3f angularVelocity = Eigen::Vector3f::Zero();
+		Eigen::Vector3f angularAcceleration = Eigen::Vector3f::Zero();
+	};
+}
@@ -0,0 +1,190 @@
+#include "pose_provider.hpp"
+#include "timing.hpp"
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace Openwarp;
+
+namespace {
+
+	// Readers keep clear of the slots the producer is about to reuse,
+	// so a lookup doesn't keep racing it.
+	const uint64_t READ_MARGIN = 16;
+
+	const float TWO_PI = 6.28318530718f;
+}
+
+void PoseHistory::Push(const PoseSample& sample) {
+	uint64_t index = count.load(std::memory_order_relaxed);
+	Slot& slot = slots[index % CAPACITY];
+
+	uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+	slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.sample = sample;
+	slot.sequence.store(sequence + 2, std::memory_order_release);
+
+	count.store(index + 1, std::memory_order_release);
+}
+
+bool PoseHistory::read(uint64_t index, PoseSample& out) const {
+	const Slot& slot = slots[index % CAPACITY];
+
+	// The index'th push is the slot's (index / CAPACITY + 1)'th write.
+	uint32_t expected = (uint32_t)(2 * (index / CAPACITY + 1));
+	if(slot.sequence.load(std::memory_order_acquire) != expected) {
+		return false;
+	}
+	out = slot.sample;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+bool PoseHistory::Latest(PoseSample& out) const {
+	for(;;) {
+		uint64_t n = Count();
+		if(n == 0) {
+			return false;
+		}
+		// Only fails if the producer lapped the whole ring meanwhile.
+		if(read(n - 1, out)) {
+			return true;
+		}
+	}
+}
+
+bool PoseHistory::Sample(double time, PoseSample& out) const {
+	for(;;) {
+		uint64_t n = Count();
+		if(n == 0) {
+			return false;
+		}
+		uint64_t oldest = n > CAPACITY - READ_MARGIN ? n - (CAPACITY - READ_MARGIN) : 0;
+
+		// Queries are almost always for the last few milliseconds,
+		// so walk back from the newest sample.
+		PoseSample after, before;
+		if(!read(n - 1, after)) {
+			continue;
+		}
+		if(time >= after.time) {
+			out = after;
+			return true;
+		}
+
+		bool torn = false;
+		for(uint64_t i = n - 1; i-- > oldest;) {
+			if(!read(i, before)) {
+				torn = true;
+				break;
+			}
+			if(before.time <= time) {
+				double span = after.time - before.time;
+				float t = span > 0.0 ? (float)((time - before.time) / span) : 1.0f;
+				out.time = time;
+				out.position = before.position + (after.position - before.position) * t;
+				out.orientation = before.orientation.slerp(t, after.orientation);
+				return true;
+			}
+			after = before;
+		}
+		if(!torn) {
+			// Older than anything retained.
+			out = after;
+			return true;
+		}
+	}
+}
+
+size_t PoseHistory::SamplesAfter(double after, PoseSample* out, size_t maxCount) const {
+	for(;;) {
+		uint64_t n = Count();
+		uint64_t oldest = n > CAPACITY - READ_MARGIN ? n - (CAPACITY - READ_MARGIN) : 0;
+		oldest = std::max(oldest, n - std::min<uint64_t>(n, maxCount));
+
+		// Find the first sample later than after, walking back from the newest.
+		uint64_t first = n;
+		PoseSample sample;
+		bool torn = false;
+		while(first > oldest) {
+			if(!read(first - 1, sample)) {
+				torn = true;
+				break;
+			}
+			if(sample.time <= after) {
+				break;
+			}
+			first--;
+		}
+		if(torn) {
+			continue;
+		}
+
+		size_t copied = 0;
+		for(uint64_t i = first; i < n; i++) {
+			if(!read(i, out[copied])) {
+				torn = true;
+				break;
+			}
+			copied++;
+		}
+		if(!torn) {
+			return copied;
+		}
+	}
+}
+
+void SyntheticPoseProvider::Start() {
+	if(thread.joinable()) {
+		return;
+	}
+	stop = false;
+	thread = std::thread(&SyntheticPoseProvider::run, this);
+}
+
+void SyntheticPoseProvider::Stop() {
+	if(!thread.joinable()) {
+		return;
+	}
+	stop = true;
+	thread.join();
+}
+
+PoseSample SyntheticPoseProvider::generate(double time) const {
+	// Incommensurate frequencies, so the motion doesn't visibly loop.
+	float t = (float)time;
+	Eigen::Vector3f offset(
+		0.05f * std::sin(TWO_PI * 0.50f * t),
+		0.02f * std::sin(TWO_PI * 0.93f * t),
+		0.03f * std::sin(TWO_PI * 0.31f * t)
+	);
+	float yaw = 0.30f * std::sin(TWO_PI * 0.23f * t);
+	float pitch = 0.10f * std::sin(TWO_PI * 0.41f * t);
+
+	PoseSample sample;
+	sample.time = time;
+	sample.position = origin + baseOrientation * (offset * amplitude);
+	sample.orientation = baseOrientation
+		* Eigen::AngleAxisf(yaw * amplitude, Eigen::Vector3f::UnitY())
+		* Eigen::AngleAxisf(pitch * amplitude, Eigen::Vector3f::UnitX());
+	return sample;
+}
+
+void SyntheticPoseProvider::run() {
+	double interval = 1.0 / std::max(rateHz, 1.0);
+	double nextSample = glfwGetTime();
+	while(!stop) {
+		double now = glfwGetTime();
+		history.Push(generate(now));
+
+		// Samples are timestamped, so an oversleep only delays the
+		// next one; if we fall a whole interval behind, don't try to catch up.
+		nextSample += interval;
+		if(nextSample < now) {
+			nextSample = now + interval;
+		}
+		PreciseSleepUntil(nextSample, 0.0);
+	}
+}
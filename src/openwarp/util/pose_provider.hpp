@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace Openwarp {
+
+	struct PoseSample {
+		double time = 0.0;    // seconds, glfwGetTime()
+		Eigen::Vector3f position = Eigen::Vector3f::Zero();
+		Eigen::Quaternionf orientation = Eigen::Quaternionf::Identity();
+	};
+
+	// Ring of the most recent timestamped poses. One producer thread
+	// pushes; any number of consumer threads read, without locks.
+	//
+	// Each slot is a seqlock: its sequence number is odd while the
+	// producer is writing it, and goes up by two per write, so a reader
+	// that copied a sample can tell whether it was torn or overwritten
+	// and try again. The producer never waits on readers.
+	class PoseHistory {
+		public:
+		// About a second of history at 1 kHz.
+		static const size_t CAPACITY = 1024;
+
+		// Producer thread only. Times must not decrease.
+		void Push(const PoseSample& sample);
+
+		// Newest sample. False if nothing has been pushed yet.
+		bool Latest(PoseSample& out) const;
+
+		// Pose at time, interpolated between the samples either side of
+		// it, and clamped to the oldest and newest retained samples.
+		// False if nothing has been pushed yet.
+		bool Sample(double time, PoseSample& out) const;
+
+		// Copy the newest samples later than after, up to maxCount of
+		// them, oldest first. Returns how many were copied.
+		size_t SamplesAfter(double after, PoseSample* out, size_t maxCount) const;
+
+		// Number of samples ever pushed.
+		uint64_t Count() const { return count.load(std::memory_order_acquire); }
+
+		private:
+		struct Slot {
+			std::atomic<uint32_t> sequence{0};
+			PoseSample sample;
+		};
+
+		// Copy out the sample pushed as the index'th. False if it has
+		// been overwritten, or is being written right now.
+		bool read(uint64_t index, PoseSample& out) const;
+
+		Slot slots[CAPACITY];
+		std::atomic<uint64_t> count{0};
+	};
+
+	// A source of head poses, delivered into a PoseHistory from
+	// whichever thread the source runs on.
+	class PoseProvider {
+		public:
+		virtual ~PoseProvider() = default;
+
+		virtual void Start() {}
+		virtual void Stop() {}
+
+		const PoseHistory& History() const { return history; }
+
+		protected:
+		PoseHistory history;
+	};
+
+	// Adapter for the pose integrated from GLFW keyboard and mouse input
+	// on the main thread, which pushes one sample per loop iteration.
+	class InputPoseProvider : public PoseProvider {
+		public:
+		void Push(double time, const Eigen::Vector3f& position, const Eigen::Quaternionf& orientation) {
+			history.Push({time, position, orientation});
+		}
+	};
+
+	// Stand-in for a real tracker: a thread of its own samples a smooth,
+	// repeating head motion (sway, bob, turn and nod) around an origin
+	// pose at rateHz.
+	class SyntheticPoseProvider : public PoseProvider {
+		public:
+		~SyntheticPoseProvider() override { Stop(); }
+
+		void Start() override;
+		void Stop() override;
+
+		bool Running() const { return thread.joinable(); }
+
+		// Set these before Start().
+		double rateHz = 1000.0;
+		Eigen::Vector3f origin = Eigen::Vector3f::Zero();
+		Eigen::Quaternionf baseOrientation = Eigen::Quaternionf::Identity();
+
+		// Scales the motion; 1 is a brisk look around.
+		float amplitude = 1.0f;
+
+		private:
+		PoseSample generate(double time) const;
+		void run();
+
+		std::thread thread;
+		std::atomic<bool> stop{false};
+	};
+}
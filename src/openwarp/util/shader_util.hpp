@@ -30,14 +30,56 @@ static void GLAPIENTRY
 #endif
 	}
 
-int init_and_link(const char* vert_filename, const char* frag_filename){
+// Read a shader from disk, replacing any #include "file" lines with the
+// contents of that file (relative to the including shader's directory).
+// GLSL has no #include of its own; this lets shaders share code.
+std::string load_shader_source(const std::string& filename){
+
+    std::ifstream file(filename);
+    if(!file){
+        printf("Could not open shader %s\n", filename.c_str());
+        abort();
+    }
+
+    std::string directory = filename.substr(0, filename.find_last_of('/') + 1);
+
+    std::stringstream source;
+    std::string line;
+    while(std::getline(file, line)){
+        size_t directive = line.find("#include");
+        size_t open = line.find('"');
+        size_t close = line.rfind('"');
+        if(directive == line.find_first_not_of(" \t") && directive != std::string::npos &&
+            open != std::string::npos && close > open){
+            source << load_shader_source(directory + line.substr(open + 1, close - open - 1));
+        } else {
+            source << line << '\n';
+        }
+    }
+
+    return source.str();
+}
+
+// Insert extra lines (typically #defines selecting a shader variant)
+// right after the #version directive, which has to come first.
+std::string insert_after_version(const std::string& source, const std::string& lines){
+    if(lines.empty()){
+        return source;
+    }
+    size_t version = source.find("#version");
+    size_t end = source.find('\n', version);
+    if(version == std::string::npos || end == std::string::npos){
+        return lines + source;
+    }
+    return source.substr(0, end + 1) + lines + source.substr(end + 1);
+}
 
-    std::ifstream vert_file(vert_filename);
-    std::string vertex_shader((std::istreambuf_iterator<char>(vert_file)), std::istreambuf_iterator<char>());
+int init_and_link(const char* vert_filename, const char* frag_filename, const std::string& defines = ""){
+
+    std::string vertex_shader = insert_after_version(load_shader_source(vert_filename), defines);
     const char* vertex_shader_source = vertex_shader.c_str();
     
-    std::ifstream frag_file(frag_filename);
-    std::string fragment_shader((std::istreambuf_iterator<char>(frag_file)), std::istreambuf_iterator<char>());
+    std::string fragment_shader = insert_after_version(load_shader_source(frag_filename), defines);
     const char* fragment_shader_source = fragment_shader.c_str();
 
     //std::cout << vertex_shader << std::endl;
@@ -128,3 +170,50 @@ int init_and_link(const char* vert_filename, const char* frag_filename){
     return shader_program;
 
 }
+
+int init_and_link_compute(const char* comp_filename){
+
+    std::string compute_shader = load_shader_source(comp_filename);
+    const char* compute_shader_source = compute_shader.c_str();
+
+    // GL handles for intermediary objects.
+    GLint result, compute_shader_handle, shader_program;
+
+    compute_shader_handle = glCreateShader(GL_COMPUTE_SHADER);
+    GLint cshader_len = compute_shader.length();
+    glShaderSource(compute_shader_handle, 1, &compute_shader_source, &cshader_len);
+    glCompileShader(compute_shader_handle);
+    glGetShaderiv(compute_shader_handle, GL_COMPILE_STATUS, &result);
+    if ( result == GL_FALSE )
+    {
+        GLchar msg[4096];
+        GLsizei length;
+        glGetShaderInfoLog( compute_shader_handle, sizeof( msg ), &length, msg );
+        printf( "Compute shader error (%s): %s\n", comp_filename, msg);
+        abort();
+    }
+
+    // Create program and link shader
+    shader_program = glCreateProgram();
+    glAttachShader(shader_program, compute_shader_handle);
+    glLinkProgram(shader_program);
+
+    glGetProgramiv(shader_program, GL_LINK_STATUS, &result);
+    if ( result == GL_FALSE )
+    {
+        GLsizei length = 0;
+        glGetProgramiv(shader_program, GL_INFO_LOG_LENGTH, &length);
+
+        std::vector<GLchar> infoLog(length);
+        glGetProgramInfoLog(shader_program, length, &length, &infoLog[0]);
+
+        std::string error_msg(infoLog.begin(), infoLog.end());
+        std::cout << error_msg;
+        abort();
+    }
+
+    // After successful link, detach shader from shader program
+    glDetachShader(shader_program, compute_shader_handle);
+
+    return shader_program;
+}
@@ -0,0 +1,93 @@
+#include "stall_injector.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace Openwarp;
+
+StallInjector::StallInjector() : rng(std::random_device{}()) {}
+
+bool StallInjector::LoadProfile(const std::string& path) {
+	std::ifstream file(path);
+	if(!file) {
+		std::cerr << "Could not open frame-time profile " << path << std::endl;
+		return false;
+	}
+
+	std::vector<float> loaded;
+	std::string line;
+	while(std::getline(file, line)) {
+		if(line.empty() || line[0] == '#') {
+			continue;
+		}
+		std::replace(line.begin(), line.end(), ',', ' ');
+		std::stringstream stream(line);
+		float frameMs;
+		if(stream >> frameMs && frameMs >= 0.0f) {
+			loaded.push_back(frameMs);
+		}
+	}
+	if(loaded.empty()) {
+		std::cerr << "No frame times in profile " << path << std::endl;
+		return false;
+	}
+
+	std::cout << "Loaded " << loaded.size() << " frame times from " << path << std::endl;
+	std::lock_guard<std::mutex> lock(mutex);
+	profile = std::move(loaded);
+	return true;
+}
+
+StallSettings StallInjector::Settings() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return settings;
+}
+
+void StallInjector::Configure(const StallSettings& newSettings) {
+	std::lock_guard<std::mutex> lock(mutex);
+	settings = newSettings;
+}
+
+size_t StallInjector::ProfileSize() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return profile.size();
+}
+
+StallPlan StallInjector::Next() {
+	std::lock_guard<std::mutex> lock(mutex);
+	uint64_t frame = frames++;
+
+	double costMs = 0.0;
+	StallPlan plan;
+	switch(settings.mode) {
+		case StallMode::None:
+			break;
+		case StallMode::Fixed:
+			costMs = settings.extraMs;
+			break;
+		case StallMode::Spikes:
+			if(settings.spikePeriod > 0 && frame % settings.spikePeriod == 0) {
+				costMs = settings.spikeMs;
+			}
+			break;
+		case StallMode::RandomDrops:
+			plan.drop = std::uniform_real_distribution<float>(0.0f, 1.0f)(rng) < settings.dropChance;
+			break;
+		case StallMode::Recorded:
+			if(!profile.empty()) {
+				size_t index = std::uniform_int_distribution<size_t>(0, profile.size() - 1)(rng);
+				costMs = std::max(0.0f, profile[index] - settings.baselineMs);
+			}
+			break;
+	}
+
+	if(plan.drop) {
+		dropped++;
+	} else if(costMs > 0.0) {
+		stalled++;
+		(settings.onGpu ? plan.gpuMs : plan.cpuMs) = costMs;
+	}
+	return plan;
+}
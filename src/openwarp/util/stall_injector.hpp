@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Openwarp {
+
+	enum class StallMode {
+		None,
+		Fixed,          // extraMs on every frame
+		Spikes,         // spikeMs every spikePeriod frames
+		RandomDrops,    // skip frames with probability dropChance
+		Recorded,       // frame times drawn from a loaded profile
+	};
+
+	struct StallSettings {
+		StallMode mode = StallMode::None;
+
+		// Spend the extra cost on the GPU, rather than the render thread.
+		bool onGpu = false;
+
+		float extraMs = 5.0f;
+		float spikeMs = 50.0f;
+		int spikePeriod = 30;
+		float dropChance = 0.1f;
+
+		// Recorded frame times are whole frames; subtract what
+		// rendering the scene already costs.
+		float baselineMs = 0.0f;
+	};
+
+	// What to do to one rendered frame.
+	struct StallPlan {
+		double cpuMs = 0.0;
+		double gpuMs = 0.0;
+		bool drop = false;
+	};
+
+	// Makes the "application" struggle on purpose, so reprojection can be
+	// benchmarked under realistic load: fixed extra cost, periodic spikes,
+	// randomly dropped frames, or costs replayed from a recorded
+	// frame-time distribution.
+	//
+	// Settings may be changed from any thread; Next() is called by
+	// whichever thread renders.
+	class StallInjector {
+		public:
+		StallInjector();
+
+		// Load frame times for StallMode::Recorded: the first number on
+		// each line, in milliseconds. Blank lines, lines starting with
+		// '#', and anything that doesn't parse (e.g. a CSV header) are
+		// skipped. Returns false if the file has no usable frame times.
+		bool LoadProfile(const std::string& path);
+
+		StallSettings Settings() const;
+		void Configure(const StallSettings& settings);
+
+		// Plan the next frame.
+		StallPlan Next();
+
+		size_t ProfileSize() const;
+		uint64_t Frames() const { return frames; }
+		uint64_t Stalled() const { return stalled; }
+		uint64_t Dropped() const { return dropped; }
+
+		private:
+		mutable std::mutex mutex;
+		StallSettings settings;
+		std::vector<float> profile;
+		std::mt19937 rng;
+
+		std::atomic<uint64_t> frames{0};
+		std::atomic<uint64_t> stalled{0};
+		std::atomic<uint64_t> dropped{0};
+	};
+}
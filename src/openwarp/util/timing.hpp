@@ -0,0 +1,21 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <thread>
+
+namespace Openwarp {
+
+	// Sleep until glfwGetTime() reaches deadline. OS sleeps can overshoot
+	// by a scheduler tick or more, so only sleep until spinMargin seconds
+	// before the deadline, and spin for the rest.
+	inline void PreciseSleepUntil(double deadline, double spinMargin = 0.002) {
+		double remaining = deadline - glfwGetTime();
+		if(remaining > spinMargin) {
+			std::this_thread::sleep_for(std::chrono::duration<double>(remaining - spinMargin));
+		}
+		while(glfwGetTime() < deadline) {
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#include "vsync_scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Openwarp;
+
+void VsyncScheduler::Reset(double refreshRate) {
+	period = 1.0 / (refreshRate > 0 ? refreshRate : 60.0);
+	lastVsync = 0.0;
+	targetVsync = 0.0;
+	cpuMs = 0.0;
+	frames = 0;
+	misses = 0;
+}
+
+double VsyncScheduler::NextVsync(double now) const {
+	if(lastVsync == 0.0) {
+		return now;
+	}
+	double refreshes = std::floor((now - lastVsync) / period) + 1.0;
+	return lastVsync + refreshes * period;
+}
+
+double VsyncScheduler::FrameStartTime(double now, double warpGpuMs) {
+	targetVsync = NextVsync(now);
+	double costMs = cpuMs + warpGpuMs + safetyMarginMs;
+
+	// If that's already too late for this vsync, don't sleep
+	// at all; the frame will miss it.
+	return std::max(now, targetVsync - costMs / 1000.0);
+}
+
+void VsyncScheduler::FrameSubmitted(double startTime, double submitTime) {
+	double ms = (submitTime - startTime) * 1000.0;
+
+	// React quickly to frames getting more expensive,
+	// and slowly to them getting cheaper.
+	cpuMs = (ms > cpuMs) ? ms : cpuMs * 0.95 + ms * 0.05;
+}
+
+void VsyncScheduler::FramePresented(double presentTime) {
+	if(lastVsync != 0.0) {
+		double refreshes = std::round((presentTime - lastVsync) / period);
+
+		// Only refine the period from swaps one refresh apart,
+		// so misses and jitter don't drag it around.
+		if(refreshes == 1.0) {
+			period = period * 0.95 + (presentTime - lastVsync) * 0.05;
+		}
+
+		frames++;
+		if(presentTime > targetVsync + period / 2) {
+			misses++;
+		}
+	}
+	lastVsync = presentTime;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Openwarp {
+
+	// Schedules the warp just in time for the next vsync, so the pose it
+	// samples is as fresh as possible at scanout, rather than up to a
+	// whole refresh old after blocking in the swap.
+	//
+	// The vsync is predicted from the times buffer swaps complete, which
+	// (with vsync on, and a glFinish after the swap) is when the display
+	// flipped. The refresh period starts at the monitor's nominal rate and
+	// is refined from consecutive swaps one refresh apart.
+	class VsyncScheduler {
+		public:
+		// Forget all history, and start from the nominal refresh rate.
+		void Reset(double refreshRate);
+
+		// Predicted time of the first vsync after now.
+		double NextVsync(double now) const;
+
+		// When to start the next frame, so that it is submitted
+		// safetyMarginMs before the next vsync, given the GPU time
+		// of the warp. That vsync becomes the frame's deadline.
+		double FrameStartTime(double now, double warpGpuMs);
+
+		// A frame was started at startTime, and handed to the swap at
+		// submitTime. Tracks the CPU side of the frame cost.
+		void FrameSubmitted(double startTime, double submitTime);
+
+		// The swap of the frame completed at presentTime. If that was
+		// later than the vsync the frame was aimed at, it missed its deadline.
+		void FramePresented(double presentTime);
+
+		double Period() const { return period; }
+		double CpuMs() const { return cpuMs; }
+		uint64_t Frames() const { return frames; }
+		uint64_t Misses() const { return misses; }
+
+		float safetyMarginMs = 1.5f;
+
+		private:
+		double period = 1.0 / 60.0;
+		double lastVsync = 0.0;
+		double targetVsync = 0.0;
+		double cpuMs = 0.0;
+		uint64_t frames = 0;
+		uint64_t misses = 0;
+	};
+}